@@ -4,7 +4,13 @@
 #include "Breakable/BreakableActor.h"
 #include "GeometryCollection/GeometryCollectionComponent.h"
 #include "Items/Treasure.h"
+#include "Items/PickupPoolSubsystem.h"
 #include "Components/CapsuleComponent.h"
+#include "Subsystems/FieldPoolSubsystem.h"
+#include "Slash/SlashCollision.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Treasure Spawns"), STAT_TreasureSpawns, STATGROUP_SlashSpawns);
 
 
 ABreakableActor::ABreakableActor()
@@ -16,6 +22,7 @@ ABreakableActor::ABreakableActor()
 	GeometryCollection->SetGenerateOverlapEvents(true);
 	GeometryCollection->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GeometryCollection->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+	GeometryCollection->SetCollisionResponseToChannel(ECC_WeaponTrace, ECollisionResponse::ECR_Block);
 
 	Capsule = CreateDefaultSubobject<UCapsuleComponent>(TEXT("Capsule"));
 	Capsule->SetupAttachment(GetRootComponent());
@@ -26,6 +33,30 @@ ABreakableActor::ABreakableActor()
 void ABreakableActor::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Weapon impacts only apply fields when a breakable is around.
+	if (UFieldPoolSubsystem* FieldPool = GetWorld()->GetSubsystem<UFieldPoolSubsystem>())
+	{
+		FieldPool->RegisterBreakable(this);
+	}
+
+	if (UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>())
+	{
+		for (const TSubclassOf<ATreasure>& TreasureClass : TreasureClasses)
+		{
+			PickupPool->PrewarmPickups(TreasureClass);
+		}
+	}
+}
+
+void ABreakableActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFieldPoolSubsystem* FieldPool = GetWorld()->GetSubsystem<UFieldPoolSubsystem>())
+	{
+		FieldPool->UnregisterBreakable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ABreakableActor::Tick(float DeltaTime)
@@ -39,17 +70,23 @@ void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 
 	bBroken = true;
 
-	UWorld* World = GetWorld();
-	if (World && TreasureClasses.Num() > 0)
+	UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool && TreasureClasses.Num() > 0)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_TreasureSpawns);
+		SLASH_PERF_SCOPE(ESPS_Spawns);
+		SLASH_PERF_COUNT(ESPS_Spawns, 1);
+
 		FVector Location = GetActorLocation();
 		Location.Z += 75.0f;
 
 		const int32 Selection = FMath::RandRange(0, TreasureClasses.Num() - 1);
-		World->SpawnActor<ATreasure>(
+		// Treasures keep the gold of their class, nothing to set up.
+		PickupPool->AcquirePickup<ATreasure>(
 			TreasureClasses[Selection],
-			Location,
-			GetActorRotation()
+			FTransform(GetActorRotation(), Location),
+			nullptr,
+			[](ATreasure*) {}
 		);
 	}
 }
@@ -5,15 +5,18 @@
 #include "Components/CapsuleComponent.h"
 #include "Items/Weapons/Weapon.h"
 #include "Components/AttributeComponent.h"
+#include "Components/HitboxComponent.h"
 #include <Kismet/GameplayStatics.h>
 #include "Characters/CharacterTypes.h"
 #include "NiagaraFunctionLibrary.h"
+#include "Subsystems/SpatialHashSubsystem.h"
 
 ABaseCharacter::ABaseCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
 	Attributes = CreateDefaultSubobject<UAttributeComponent>(TEXT("Attributes"));
+	Hitboxes = CreateDefaultSubobject<UHitboxComponent>(TEXT("Hitboxes"));
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 }
 
@@ -22,11 +25,23 @@ void ABaseCharacter::BeginPlay()
 	Super::BeginPlay();
 }
 
+void ABaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Characters register themselves in the spatial hash from their own `BeginPlay()`.
+	if (USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ABaseCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
 	if (IsAlive() && Hitter)
 	{
-		DirectionalHitReact(Hitter->GetActorLocation());
+		// Where the weapon met the hitboxes, so a hit on the side reacts to that side wherever the hitter stands.
+		DirectionalHitReact(ImpactPoint);
 	}
 	else {
 		// Since IsAlive() is false, the character will die
@@ -43,8 +58,8 @@ void ABaseCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor* H
 
 void ABaseCharacter::Attack()
 {
-	// If the `CombatTarget` has a tag called 'Dead' then remove it.
-	if (CombatTarget && CombatTarget->ActorHasTag(FName("Dead")))
+	// If the `CombatTarget` is dead then remove it.
+	if (CombatTarget && (GetCombatFlags(CombatTarget) & ECombatFlags::ECF_Dead))
 	{
 		CombatTarget = nullptr;
 	}
@@ -52,10 +67,13 @@ void ABaseCharacter::Attack()
 
 void ABaseCharacter::Die_Implementation()
 {
-	// Add a 'Dead' tag to the character.
+	// Flag the character as dead, the 'Dead' tag is kept for designers.
+	CombatFlags |= ECombatFlags::ECF_Dead;
 	Tags.Add(FName("Dead"));
 
 	PlayDeathMontage();
+
+	OnCharacterDied.Broadcast(this);
 }
 
 int32 ABaseCharacter::PlayAttackMontage()
@@ -299,6 +317,27 @@ void ABaseCharacter::DodgeEnd()
 {
 }
 
+uint8 ABaseCharacter::GetCombatFlags(const AActor* Actor)
+{
+	if (const ABaseCharacter* Character = Cast<ABaseCharacter>(Actor))
+	{
+		return Character->CombatFlags;
+	}
+	if (Actor == nullptr || Actor->Tags.Num() == 0) return ECombatFlags::ECF_None;
+
+	// Other actors, e.g. pawns set up by designers, only have their tags.
+	uint8 Flags = ECombatFlags::ECF_None;
+	if (Actor->ActorHasTag(FName("Enemy"))) Flags |= ECombatFlags::ECF_Enemy;
+	if (Actor->ActorHasTag(FName("EngageableTarget"))) Flags |= ECombatFlags::ECF_EngageableTarget;
+	if (Actor->ActorHasTag(FName("Dead"))) Flags |= ECombatFlags::ECF_Dead;
+	return Flags;
+}
+
+bool ABaseCharacter::AreSameFaction(const AActor* Actor, const AActor* OtherActor)
+{
+	return (GetCombatFlags(Actor) & GetCombatFlags(OtherActor) & ECombatFlags::ECF_Factions) != 0;
+}
+
 bool ABaseCharacter::IsAlive()
 {
 	return Attributes && Attributes->IsAlive();
@@ -319,6 +358,6 @@ void ABaseCharacter::SetWeaponCollisionEnabled(ECollisionEnabled::Type Collision
 	if (EquippedWeapon && EquippedWeapon->GetWeaponBox())
 	{
 		EquippedWeapon->GetWeaponBox()->SetCollisionEnabled(CollisionEnabled);
-		EquippedWeapon->IgnoreActors.Empty();
+		EquippedWeapon->SetHitDetectionEnabled(CollisionEnabled != ECollisionEnabled::NoCollision);
 	}
 }
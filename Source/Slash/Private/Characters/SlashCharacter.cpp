@@ -21,11 +21,15 @@
 #include "Items/Soul.h"
 #include "Items/Treasure.h"
 #include "Items/Health.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 ASlashCharacter::ASlashCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	CombatFlags = ECombatFlags::ECF_EngageableTarget;
+
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(GetRootComponent());
 	CameraBoom->TargetArmLength = 300.f;
@@ -45,8 +49,9 @@ ASlashCharacter::ASlashCharacter()
 	GetMesh()->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
 	GetMesh()->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
-	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
-	GetMesh()->SetGenerateOverlapEvents(true);
+
+	// Weapons hit the capsules of `Hitboxes`, not the mesh.
+	GetMesh()->SetGenerateOverlapEvents(false);
 
 	ViewCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("ViewCamera"));
 	ViewCamera->SetupAttachment(CameraBoom);
@@ -63,6 +68,7 @@ ASlashCharacter::ASlashCharacter()
 	CombatTargetDetectorSphere->SetSphereRadius(AttackRadius);
 	CombatTargetDetectorSphere->SetupAttachment(GetMesh());
 	CombatTargetDetectorSphere->SetRelativeLocation(FVector(0.0f, 0.0f, 90.0f));
+	CombatTargetDetectorSphere->SetCollisionProfileName(SlashCollisionProfile::Sensor);
 
 	EchoMotionWarping = CreateDefaultSubobject<UMotionWarpingComponent>(TEXT("EchoMotionWarping"));
 	EchoMotionWarping->SetAutoActivate(true);
@@ -167,12 +173,15 @@ void ASlashCharacter::BeginPlay()
 		InitializeSlashOverlay(PlayerController);
 	}
 
-	// Add the tag to this character.
-	// This can be helpful at some places where we want to check if the AActor is this character or not.
-	// This is also used to decide show/hide the damage HUD on weapons.
-	// So, instead of expensive type-casting operation, checking the below tag value on AActor is cheaper.
+	// Add the tag to this character, for designers.
+	// Gameplay code checks `ECombatFlags::ECF_EngageableTarget` instead, set in the constructor.
 	Tags.Add(FName("EngageableTarget"));
 
+	if (USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>())
+	{
+		SpatialHash->RegisterActor(this, ESpatialCategory::ESC_Player);
+	}
+
 	CombatTargetDetectorSphere->OnComponentBeginOverlap.AddDynamic(this, &ASlashCharacter::OnSphereOverlap);
 	CombatTargetDetectorSphere->OnComponentEndOverlap.AddDynamic(this, &ASlashCharacter::OnSphereEndOverlap);
 }
@@ -390,28 +399,29 @@ void ASlashCharacter::CheckAndSetCombatTarget()
 		return;
 	}
 
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	const FVector MyLocation = SpatialHash ? SpatialHash->GetCachedLocation(this) : GetActorLocation();
+
 	// Initialize closest Enemy distance to maximum value of `double` type.
-	double ClosestEnemyDistance = DBL_MAX;
+	double ClosestEnemyDistanceSquared = DBL_MAX;
 
 	// Set the `CombatTarget` based on which Enemy is closest to Character.
 	for (int32 index = 0; index < InRangeCombatTargets.Num(); index++)
 	{
 		AActor* Target = InRangeCombatTargets[index];
+		if (Target == nullptr) continue;
 
-		// Get `TargetLocation` of Enemy.
-		const FVector TargetLocation = (Target) ? Target->GetActorLocation() : FVector();
-
-		// Compute distance between Enemy to Character.
-		double EnemyToMeDistance = (GetActorLocation() - TargetLocation).Size();
+		// Get `TargetLocation` of Enemy, cached for this frame by the spatial hash.
+		const FVector TargetLocation = SpatialHash ? SpatialHash->GetCachedLocation(Target) : Target->GetActorLocation();
 
-		// Check & ensure to avoid negative distance.
-		EnemyToMeDistance = (EnemyToMeDistance < 0) ? (EnemyToMeDistance * -1) : EnemyToMeDistance;
+		// Compare squared distances, no need for the square root to find the closest one.
+		const double EnemyToMeDistanceSquared = FVector::DistSquared(MyLocation, TargetLocation);
 
 		// Update the `CombatTarget` if required.
-		if (ClosestEnemyDistance > EnemyToMeDistance)
+		if (ClosestEnemyDistanceSquared > EnemyToMeDistanceSquared)
 		{
 			CombatTarget = Target;
-			ClosestEnemyDistance = EnemyToMeDistance;
+			ClosestEnemyDistanceSquared = EnemyToMeDistanceSquared;
 
 			// GEngine->AddOnScreenDebugMessage(4, 5.0f, FColor::Green, FString::Printf(TEXT("Locked CombatTarget = %s"), *CombatTarget->GetName()));
 		}
@@ -430,7 +440,7 @@ void ASlashCharacter::RemoveMotionWarping()
 
 void ASlashCharacter::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	if (OtherActor->ActorHasTag(FName("Enemy")))
+	if (GetCombatFlags(OtherActor) & ECombatFlags::ECF_Enemy)
 	{
 		// Add `OtherActor` to array.
 		InRangeCombatTargets.AddUnique(OtherActor);
@@ -439,7 +449,7 @@ void ASlashCharacter::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent,
 
 void ASlashCharacter::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	if (OtherActor->ActorHasTag(FName("Enemy")))
+	if (GetCombatFlags(OtherActor) & ECombatFlags::ECF_Enemy)
 	{
 		// Remove `OtherActor` from array.
 		InRangeCombatTargets.Remove(OtherActor);
@@ -0,0 +1,316 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/SlashAIBenchmarkCommandlet.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/TargetPoint.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/DefaultPawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NavigationSystem.h"
+#include "Slash/SlashStats.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSlashAIBenchmark, Log, All);
+
+USlashAIBenchmarkCommandlet::USlashAIBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USlashAIBenchmarkCommandlet::Main(const FString& Params)
+{
+	FRunSettings Settings;
+	FString EnemyClassName;
+	FString CompareCounts;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/AIBenchmark.csv");
+	int32 NumEnemies = 100;
+
+	FParse::Value(*Params, TEXT("Map="), Settings.MapName);
+	FParse::Value(*Params, TEXT("EnemyClass="), EnemyClassName);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Enemies="), NumEnemies);
+	FParse::Value(*Params, TEXT("Compare="), CompareCounts, false);
+	FParse::Value(*Params, TEXT("Frames="), Settings.NumFrames);
+	FParse::Value(*Params, TEXT("FPS="), Settings.FramesPerSecond);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Radius="), Settings.Radius);
+
+	// A native `AEnemy` has no mesh, animations or weapon, pass the game's enemy blueprint for real numbers.
+	Settings.EnemyClass = EnemyClassName.IsEmpty() ? AEnemy::StaticClass() : LoadClass<AEnemy>(nullptr, *EnemyClassName);
+	if (Settings.EnemyClass == nullptr)
+	{
+		UE_LOG(LogSlashAIBenchmark, Error, TEXT("Can't load enemy class '%s'."), *EnemyClassName);
+		return 1;
+	}
+
+	if (!CompareCounts.IsEmpty())
+	{
+		return RunComparison(Settings, CompareCounts, OutputPath);
+	}
+
+	FString Csv;
+	FRunResult Result;
+	if (!RunBenchmark(Settings, NumEnemies, Csv, Result)) return 1;
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogSlashAIBenchmark, Error, TEXT("Can't write '%s'."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogSlashAIBenchmark, Display, TEXT("Average game thread time %.3f ms, peak used physical memory %.1f MB, written to '%s'."),
+		Result.GameThreadMs, Result.PeakUsedPhysicalMB, *OutputPath);
+
+	return 0;
+}
+
+int32 USlashAIBenchmarkCommandlet::RunComparison(const FRunSettings& Settings, const FString& CompareCounts, const FString& OutputPath)
+{
+	IConsoleVariable* BatchEnemyTick = IConsoleManager::Get().FindConsoleVariable(TEXT("slash.AI.BatchEnemyTick"));
+	if (BatchEnemyTick == nullptr) return 1;
+
+	TArray<FString> Counts;
+	CompareCounts.ParseIntoArray(Counts, TEXT(","));
+
+	const int32 InitialBatchEnemyTick = BatchEnemyTick->GetInt();
+	const FString OutputBase = FPaths::GetPath(OutputPath) / FPaths::GetBaseFilename(OutputPath);
+
+	FString Summary = TEXT("| Enemies | Path | Game thread ms | Enemy AI ms | Peak used physical MB |\n");
+	Summary += TEXT("|---:|---|---:|---:|---:|\n");
+
+	for (const FString& Count : Counts)
+	{
+		const int32 NumEnemies = FCString::Atoi(*Count);
+		if (NumEnemies <= 0) continue;
+
+		// Per actor first, so both paths load the map & spawn the same layout from a fresh world.
+		for (const bool bBatch : { false, true })
+		{
+			BatchEnemyTick->Set(bBatch ? 1 : 0, ECVF_SetByCode);
+
+			FString Csv;
+			FRunResult Result;
+			if (!RunBenchmark(Settings, NumEnemies, Csv, Result))
+			{
+				BatchEnemyTick->Set(InitialBatchEnemyTick, ECVF_SetByCode);
+				return 1;
+			}
+
+			const TCHAR* PathName = bBatch ? TEXT("Batch") : TEXT("PerActor");
+			FFileHelper::SaveStringToFile(Csv, *FString::Printf(TEXT("%s_%d_%s.csv"), *OutputBase, NumEnemies, PathName));
+
+			Summary += FString::Printf(TEXT("| %d | %s | %.3f | %.3f | %.1f |\n"),
+				NumEnemies, PathName, Result.GameThreadMs, Result.EnemyAIMs, Result.PeakUsedPhysicalMB);
+		}
+	}
+
+	BatchEnemyTick->Set(InitialBatchEnemyTick, ECVF_SetByCode);
+
+	const FString SummaryPath = OutputBase + TEXT("_Comparison.md");
+	if (!FFileHelper::SaveStringToFile(Summary, *SummaryPath))
+	{
+		UE_LOG(LogSlashAIBenchmark, Error, TEXT("Can't write '%s'."), *SummaryPath);
+		return 1;
+	}
+
+	UE_LOG(LogSlashAIBenchmark, Display, TEXT("Per actor & batch enemy AI, averages per frame, written to '%s':\n%s"), *SummaryPath, *Summary);
+
+	return 0;
+}
+
+bool USlashAIBenchmarkCommandlet::RunBenchmark(const FRunSettings& Settings, int32 NumEnemies, FString& OutCsv, FRunResult& OutResult)
+{
+	UWorld* World = LoadWorld(Settings.MapName);
+	if (World == nullptr)
+	{
+		UE_LOG(LogSlashAIBenchmark, Error, TEXT("Can't load map '%s'."), *Settings.MapName);
+		return false;
+	}
+
+	// Same layout on every run, so runs of different builds compare.
+	RandomStream.Initialize(Settings.Seed);
+	FMath::RandInit(Settings.Seed);
+
+	FVector Center = FVector::ZeroVector;
+	for (TActorIterator<APlayerStart> Iterator(World); Iterator; ++Iterator)
+	{
+		Center = Iterator->GetActorLocation();
+		break;
+	}
+
+	SpawnEnemies(World, Settings.EnemyClass, NumEnemies, Center, Settings.Radius);
+	APawn* Player = SpawnPlayer(World, Center);
+
+	UE_LOG(LogSlashAIBenchmark, Display, TEXT("Running %d frames with %d enemies on '%s'."), Settings.NumFrames, NumEnemies, *Settings.MapName);
+
+	OutCsv = TEXT("Frame,GameThreadMs,EnemyTickMs,EnemyAIBatchTickMs,CombatRangeChecksMs,MoveToTargetMs,UsedPhysicalMB,PeakUsedPhysicalMB\n");
+	const float DeltaSeconds = 1.0f / FMath::Max(Settings.FramesPerSecond, 1);
+	double TotalGameThreadSeconds = 0.0;
+	double TotalEnemyAISeconds = 0.0;
+	uint64 PeakUsedPhysical = 0;
+
+	FSlashPerf::AddCollector();
+	for (int32 Frame = 0; Frame < Settings.NumFrames; Frame++)
+	{
+		// The player circles around the center, through the enemies, so they keep seeing, chasing,
+		// attacking & losing it.
+		if (Player)
+		{
+			const float Angle = 2.0f * PI * Frame * DeltaSeconds / 20.0f;
+			Player->SetActorLocation(Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Settings.Radius * 0.5f + FVector(0.0f, 0.0f, 100.0f));
+		}
+
+		const FSlashPerfSnapshot FrameStart = FSlashPerfSnapshot::Take();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+		const double GameThreadSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		GFrameCounter++;
+
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, MemoryStats.PeakUsedPhysical);
+		TotalGameThreadSeconds += GameThreadSeconds;
+
+		// Only one of both ticks runs, depending on `slash.AI.BatchEnemyTick`.
+		const FSlashPerfSnapshot FramePerf = FSlashPerfSnapshot::Take() - FrameStart;
+		TotalEnemyAISeconds += FramePerf.GetSeconds(ESlashPerfSystem::ESPS_EnemyTick) + FramePerf.GetSeconds(ESlashPerfSystem::ESPS_EnemyAIBatchTick);
+
+		OutCsv += FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f\n"),
+			Frame,
+			GameThreadSeconds * 1000.0,
+			FramePerf.GetSeconds(ESlashPerfSystem::ESPS_EnemyTick) * 1000.0,
+			FramePerf.GetSeconds(ESlashPerfSystem::ESPS_EnemyAIBatchTick) * 1000.0,
+			FramePerf.GetSeconds(ESlashPerfSystem::ESPS_CombatRangeChecks) * 1000.0,
+			FramePerf.GetSeconds(ESlashPerfSystem::ESPS_MoveToTarget) * 1000.0,
+			MemoryStats.UsedPhysical / (1024.0 * 1024.0),
+			PeakUsedPhysical / (1024.0 * 1024.0));
+	}
+	FSlashPerf::RemoveCollector();
+
+	DestroyWorld(World);
+
+	const int32 NumFrames = FMath::Max(Settings.NumFrames, 1);
+	OutResult.GameThreadMs = TotalGameThreadSeconds * 1000.0 / NumFrames;
+	OutResult.EnemyAIMs = TotalEnemyAISeconds * 1000.0 / NumFrames;
+	OutResult.PeakUsedPhysicalMB = PeakUsedPhysical / (1024.0 * 1024.0);
+
+	return true;
+}
+
+UWorld* USlashAIBenchmarkCommandlet::LoadWorld(const FString& MapName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (World == nullptr) return nullptr;
+
+	World->AddToRoot();
+
+	// A game world, so the Slash subsystems are created like in a packaged game.
+	World->WorldType = EWorldType::Game;
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitWorld(UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.CreatePhysicsScene(true)
+		.CreateNavigation(true)
+		.CreateAISystem(true)
+		.ShouldSimulatePhysics(true));
+	World->UpdateWorldComponents(true, false);
+
+	FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
+
+	const FURL URL;
+	World->InitializeActorsForPlay(URL);
+
+	// Without game instance there is no game mode to start the match, begin play directly.
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	return World;
+}
+
+void USlashAIBenchmarkCommandlet::DestroyWorld(UWorld* World)
+{
+	for (FActorIterator Iterator(World); Iterator; ++Iterator)
+	{
+		Iterator->RouteEndPlay(EEndPlayReason::Quit);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void USlashAIBenchmarkCommandlet::SpawnEnemies(UWorld* World, TSubclassOf<AEnemy> EnemyClass, int32 NumEnemies, const FVector& Center, float Radius)
+{
+	// Targets are shared between enemies, like groups of enemies in the game levels.
+	TArray<AActor*> Targets;
+	const int32 NumTargets = FMath::Max(NumEnemies / 4, 4);
+	for (int32 Index = 0; Index < NumTargets; Index++)
+	{
+		Targets.Add(World->SpawnActor<ATargetPoint>(GetRandomLocation(World, Center, Radius), FRotator::ZeroRotator));
+	}
+
+	// Spawned like the game spawns enemies, so the pool's spawn path is part of the numbers.
+	UEnemyPoolSubsystem* EnemyPool = World->GetSubsystem<UEnemyPoolSubsystem>();
+	if (EnemyPool == nullptr) return;
+
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+	{
+		const FVector Location = GetRandomLocation(World, Center, Radius) + FVector(0.0f, 0.0f, 100.0f);
+		const FRotator Rotation(0.0f, RandomStream.FRandRange(0.0f, 360.0f), 0.0f);
+
+		AEnemy* Enemy = EnemyPool->AcquireEnemy(EnemyClass, FTransform(Rotation, Location));
+		if (Enemy == nullptr) continue;
+
+		TArray<AActor*> PatrolTargets;
+		const int32 FirstTarget = RandomStream.RandRange(0, NumTargets - 1);
+		for (int32 Offset = 0; Offset < 3; Offset++)
+		{
+			PatrolTargets.Add(Targets[(FirstTarget + Offset) % NumTargets]);
+		}
+		Enemy->SetPatrolTargets(PatrolTargets);
+	}
+}
+
+APawn* USlashAIBenchmarkCommandlet::SpawnPlayer(UWorld* World, const FVector& Location)
+{
+	// Enemies only see pawns possessed by a player controller & tagged like `ASlashCharacter`.
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	APawn* Player = World->SpawnActor<ADefaultPawn>(Location + FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator);
+	if (PlayerController == nullptr || Player == nullptr) return nullptr;
+
+	Player->Tags.Add(FName("EngageableTarget"));
+	PlayerController->Possess(Player);
+
+	return Player;
+}
+
+FVector USlashAIBenchmarkCommandlet::GetRandomLocation(UWorld* World, const FVector& Center, float Radius)
+{
+	const FVector2D Offset = FVector2D(RandomStream.VRand()).GetSafeNormal() * RandomStream.FRandRange(0.0f, Radius);
+	const FVector Location = Center + FVector(Offset, 0.0f);
+
+	// Keep everyone on the navmesh, so they can move.
+	FNavLocation NavLocation;
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	if (NavSys && NavSys->ProjectPointToNavigation(Location, NavLocation, FVector(Radius, Radius, 2000.0f)))
+	{
+		return NavLocation.Location;
+	}
+	return Location;
+}
@@ -59,7 +59,21 @@ void UAttributeComponent::AddHealth(float HealthToAdd)
 	Health = FMath::Clamp(Health + HealthToAdd, 0.0f, MaxHealth);
 }
 
+void UAttributeComponent::SetHealth(float NewHealth)
+{
+	Health = FMath::Clamp(NewHealth, 0.0f, MaxHealth);
+}
+
+void UAttributeComponent::ResetAttributes()
+{
+	Health = InitialHealth;
+	Stamina = InitialStamina;
+}
+
 void UAttributeComponent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	InitialHealth = Health;
+	InitialStamina = Stamina;
 }
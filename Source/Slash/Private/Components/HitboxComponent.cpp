@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/HitboxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "Slash/SlashCollision.h"
+
+UHitboxComponent::UHitboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Mannequin bone names, override them in Blueprints for other skeletons.
+	auto AddCapsule = [this](const TCHAR* Name, const TCHAR* StartBone, const TCHAR* EndBone, float Radius)
+	{
+		FHitboxCapsule& Capsule = Capsules.AddDefaulted_GetRef();
+		Capsule.Name = Name;
+		Capsule.StartBone = StartBone;
+		Capsule.EndBone = EndBone;
+		Capsule.Radius = Radius;
+	};
+	AddCapsule(TEXT("Head"), TEXT("head"), TEXT(""), 14.0f);
+	AddCapsule(TEXT("Torso"), TEXT("pelvis"), TEXT("neck_01"), 22.0f);
+	AddCapsule(TEXT("LeftArm"), TEXT("upperarm_l"), TEXT("hand_l"), 9.0f);
+	AddCapsule(TEXT("RightArm"), TEXT("upperarm_r"), TEXT("hand_r"), 9.0f);
+	AddCapsule(TEXT("LeftLeg"), TEXT("thigh_l"), TEXT("foot_l"), 11.0f);
+	AddCapsule(TEXT("RightLeg"), TEXT("thigh_r"), TEXT("foot_r"), 11.0f);
+}
+
+void UHitboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CreateHitboxes();
+}
+
+void UHitboxComponent::SetHitboxesActive(bool bActive)
+{
+	if (bHitboxesActive == bActive) return;
+
+	bHitboxesActive = bActive;
+	for (UCapsuleComponent* Capsule : CapsuleComponents)
+	{
+		Capsule->SetCollisionEnabled(bActive ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+	}
+
+	if (bActive)
+	{
+		UpdateHitboxes();
+	}
+}
+
+void UHitboxComponent::UpdateHitboxes()
+{
+	if (!bHitboxesActive) return;
+
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	for (int32 Index = 0; Index < CapsuleComponents.Num(); Index++)
+	{
+		FVector Location;
+		FQuat Rotation;
+
+		if (StartBoneIndices[Index] == INDEX_NONE)
+		{
+			const UCapsuleComponent* OwnerCapsule = Character->GetCapsuleComponent();
+			Location = OwnerCapsule->GetComponentLocation();
+			Rotation = OwnerCapsule->GetComponentQuat();
+		}
+		else if (EndBoneIndices[Index] == INDEX_NONE)
+		{
+			const FTransform BoneTransform = Mesh->GetBoneTransform(StartBoneIndices[Index]);
+			Location = BoneTransform.GetLocation();
+			Rotation = BoneTransform.GetRotation();
+		}
+		else
+		{
+			const FVector Start = Mesh->GetBoneTransform(StartBoneIndices[Index]).GetLocation();
+			const FVector End = Mesh->GetBoneTransform(EndBoneIndices[Index]).GetLocation();
+			Location = (Start + End) * 0.5;
+			Rotation = FQuat::FindBetweenNormals(FVector::UpVector, (End - Start).GetSafeNormal());
+		}
+
+		// Capsules aren't attached, moving them doesn't update any child or overlap.
+		CapsuleComponents[Index]->SetWorldLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+}
+
+void UHitboxComponent::CreateHitboxes()
+{
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	if (Character == nullptr) return;
+
+	Mesh = Character->GetMesh();
+
+	for (const FHitboxCapsule& Spec : Capsules)
+	{
+		const int32 StartBoneIndex = Mesh ? Mesh->GetBoneIndex(Spec.StartBone) : INDEX_NONE;
+		const int32 EndBoneIndex = Mesh && !Spec.EndBone.IsNone() ? Mesh->GetBoneIndex(Spec.EndBone) : INDEX_NONE;
+		if (StartBoneIndex == INDEX_NONE || (!Spec.EndBone.IsNone() && EndBoneIndex == INDEX_NONE)) continue;
+
+		// Bones keep their length, the capsule size is computed once from the current pose.
+		float HalfHeight = Spec.HalfHeight;
+		if (EndBoneIndex != INDEX_NONE)
+		{
+			const double BoneLength = FVector::Dist(Mesh->GetBoneTransform(StartBoneIndex).GetLocation(), Mesh->GetBoneTransform(EndBoneIndex).GetLocation());
+			HalfHeight = BoneLength * 0.5 + Spec.Radius;
+		}
+
+		CapsuleComponents.Add(CreateCapsule(Spec.Name, Spec.Radius, HalfHeight));
+		StartBoneIndices.Add(StartBoneIndex);
+		EndBoneIndices.Add(EndBoneIndex);
+	}
+
+	if (CapsuleComponents.Num() == 0)
+	{
+		float Radius;
+		float HalfHeight;
+		Character->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
+
+		CapsuleComponents.Add(CreateCapsule(FName("Body"), Radius, HalfHeight));
+		StartBoneIndices.Add(INDEX_NONE);
+		EndBoneIndices.Add(INDEX_NONE);
+	}
+}
+
+UCapsuleComponent* UHitboxComponent::CreateCapsule(const FName& Name, float Radius, float HalfHeight)
+{
+	UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(GetOwner(), *FString::Printf(TEXT("Hitbox_%s"), *Name.ToString()));
+	Capsule->InitCapsuleSize(Radius, FMath::Max(HalfHeight, Radius));
+	Capsule->SetCollisionProfileName(SlashCollisionProfile::Hitbox);
+	Capsule->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Capsule->SetGenerateOverlapEvents(false);
+	Capsule->SetCanEverAffectNavigation(false);
+	Capsule->RegisterComponent();
+	return Capsule;
+}
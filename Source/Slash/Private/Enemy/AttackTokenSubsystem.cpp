@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/AttackTokenSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+#include "Subsystems/SlashDifficultySubsystem.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Attack Tokens Held"), STAT_AttackTokensHeld, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Waiting For Attack Token"), STAT_EnemiesWaitingForAttackToken, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<int32> CVarMaxAttackers(
+	TEXT("slash.AI.AttackTokens.MaxAttackers"),
+	0,
+	TEXT("Maximum number of enemies attacking the same target at once.\n")
+	TEXT("0: Use the value of the current difficulty from the game config (default)."),
+	ECVF_Default
+);
+
+void UAttackTokenSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	BindDifficulty();
+}
+
+void UAttackTokenSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Worlds get their game instance after their subsystems in some setups.
+	BindDifficulty();
+}
+
+void UAttackTokenSubsystem::Deinitialize()
+{
+	if (USlashDifficultySubsystem* Difficulties = DifficultySubsystem.Get())
+	{
+		Difficulties->OnDifficultyChanged.Remove(DifficultyChangedHandle);
+	}
+	DifficultySubsystem = nullptr;
+
+	TargetTokens.Empty();
+	UpdateStats();
+
+	Super::Deinitialize();
+}
+
+bool UAttackTokenSubsystem::RequestToken(AEnemy* Enemy, AActor* Target)
+{
+	if (Enemy == nullptr || Target == nullptr) return true;
+
+	// An enemy only ever competes for the tokens of its current target.
+	for (FAttackTokens& Tokens : TargetTokens)
+	{
+		if (Tokens.Target != Target && Tokens.Holders.Contains(Enemy))
+		{
+			ReleaseToken(Enemy);
+			break;
+		}
+	}
+
+	FAttackTokens& Tokens = FindOrAddTokens(Target);
+	if (Tokens.Holders.Contains(Enemy)) return true;
+
+	Tokens.Holders.RemoveAll([](const TWeakObjectPtr<AEnemy>& Holder) { return !Holder.IsValid(); });
+
+	if (Tokens.Holders.Num() < GetMaxAttackers() && Tokens.Waiting.Num() == 0)
+	{
+		Tokens.Holders.Add(Enemy);
+		UpdateStats();
+		return true;
+	}
+
+	Tokens.Waiting.AddUnique(Enemy);
+	UpdateStats();
+	return false;
+}
+
+void UAttackTokenSubsystem::CancelRequest(AEnemy* Enemy)
+{
+	for (FAttackTokens& Tokens : TargetTokens)
+	{
+		if (Tokens.Waiting.Remove(Enemy) > 0)
+		{
+			UpdateStats();
+			return;
+		}
+	}
+}
+
+void UAttackTokenSubsystem::ReleaseToken(AEnemy* Enemy)
+{
+	for (FAttackTokens& Tokens : TargetTokens)
+	{
+		if (Tokens.Holders.Remove(Enemy) > 0)
+		{
+			GrantWaitingEnemies(Tokens.Target.Get());
+			UpdateStats();
+			return;
+		}
+	}
+}
+
+void UAttackTokenSubsystem::SetDifficulty(EGameDifficulty NewDifficulty)
+{
+	BindDifficulty();
+
+	if (USlashDifficultySubsystem* Difficulties = DifficultySubsystem.Get())
+	{
+		Difficulties->SetDifficulty(NewDifficulty);
+	}
+	else
+	{
+		OnDifficultyChanged(NewDifficulty);
+	}
+}
+
+void UAttackTokenSubsystem::BindDifficulty()
+{
+	if (DifficultySubsystem.IsValid()) return;
+
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	USlashDifficultySubsystem* Difficulties = GameInstance ? GameInstance->GetSubsystem<USlashDifficultySubsystem>() : nullptr;
+	if (Difficulties == nullptr) return;
+
+	DifficultySubsystem = Difficulties;
+	DifficultyChangedHandle = Difficulties->OnDifficultyChanged.AddUObject(this, &UAttackTokenSubsystem::OnDifficultyChanged);
+	OnDifficultyChanged(Difficulties->GetDifficulty());
+}
+
+void UAttackTokenSubsystem::OnDifficultyChanged(EGameDifficulty NewDifficulty)
+{
+	Difficulty = NewDifficulty;
+
+	// More tokens may be available now.
+	TArray<AActor*, TInlineAllocator<4>> Targets;
+	for (const FAttackTokens& Tokens : TargetTokens)
+	{
+		Targets.Add(Tokens.Target.Get());
+	}
+	for (const AActor* Target : Targets)
+	{
+		GrantWaitingEnemies(Target);
+	}
+	UpdateStats();
+}
+
+int32 UAttackTokenSubsystem::GetMaxAttackers() const
+{
+	const int32 Override = CVarMaxAttackers.GetValueOnGameThread();
+	if (Override > 0) return Override;
+
+	switch (Difficulty)
+	{
+	case EGameDifficulty::EGD_Easy:
+		return FMath::Max(MaxAttackersEasy, 1);
+	case EGameDifficulty::EGD_Hard:
+		return FMath::Max(MaxAttackersHard, 1);
+	default:
+		return FMath::Max(MaxAttackersNormal, 1);
+	}
+}
+
+bool UAttackTokenSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+UAttackTokenSubsystem::FAttackTokens& UAttackTokenSubsystem::FindOrAddTokens(AActor* Target)
+{
+	// Drop the entries of targets which are gone or no longer fought, before adding a new one.
+	TargetTokens.RemoveAllSwap([](const FAttackTokens& Tokens)
+	{
+		return !Tokens.Target.IsValid() || (Tokens.Holders.Num() == 0 && Tokens.Waiting.Num() == 0);
+	});
+
+	FAttackTokens* Tokens = TargetTokens.FindByPredicate([Target](const FAttackTokens& Other) { return Other.Target == Target; });
+	if (Tokens) return *Tokens;
+
+	FAttackTokens& NewTokens = TargetTokens.AddDefaulted_GetRef();
+	NewTokens.Target = Target;
+	return NewTokens;
+}
+
+void UAttackTokenSubsystem::GrantWaitingEnemies(const AActor* Target)
+{
+	if (Target == nullptr) return;
+
+	const int32 MaxAttackers = GetMaxAttackers();
+
+	while (true)
+	{
+		// Found again on every grant, the granted enemy may touch `TargetTokens`.
+		FAttackTokens* Tokens = TargetTokens.FindByPredicate([Target](const FAttackTokens& Other) { return Other.Target == Target; });
+		if (Tokens == nullptr) return;
+
+		Tokens->Holders.RemoveAll([](const TWeakObjectPtr<AEnemy>& Holder) { return !Holder.IsValid(); });
+		if (Tokens->Holders.Num() >= MaxAttackers || Tokens->Waiting.Num() == 0) return;
+
+		AEnemy* Enemy = Tokens->Waiting[0].Get();
+		Tokens->Waiting.RemoveAt(0);
+		if (Enemy == nullptr) continue;
+
+		Tokens->Holders.Add(Enemy);
+		Enemy->OnAttackTokenGranted();
+	}
+}
+
+void UAttackTokenSubsystem::UpdateStats() const
+{
+	int32 NumHeld = 0;
+	int32 NumWaiting = 0;
+	for (const FAttackTokens& Tokens : TargetTokens)
+	{
+		NumHeld += Tokens.Holders.Num();
+		NumWaiting += Tokens.Waiting.Num();
+	}
+
+	SET_DWORD_STAT(STAT_AttackTokensHeld, NumHeld);
+	SET_DWORD_STAT(STAT_EnemiesWaitingForAttackToken, NumWaiting);
+}
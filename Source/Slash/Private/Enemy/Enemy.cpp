@@ -3,24 +3,38 @@
 
 #include "Enemy/Enemy.h"
 #include "AIController.h"
+#include "Components/CapsuleComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/AttributeComponent.h"
 #include "HUD/HealthBarComponent.h"
-#include "Perception/PawnSensingComponent.h"
 #include "Items/Weapons/Weapon.h"
 #include "Items/Soul.h"
 #include "Items/Health.h"
-#include "Items/Weapons/Weapon.h"
+#include "Items/PickupPoolSubsystem.h"
+#include "Enemy/EnemyAISubsystem.h"
+#include "Enemy/AttackTokenSubsystem.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Enemy/EnemyCrowdSubsystem.h"
+#include "Enemy/PatrolRouteSubsystem.h"
+#include "Enemy/PursuitFlowFieldSubsystem.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Drop Spawns"), STAT_EnemyDropSpawns, STATGROUP_SlashSpawns);
 
 AEnemy::AEnemy()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	CombatFlags = ECombatFlags::ECF_Enemy;
+
 	GetMesh()->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
-	GetMesh()->SetGenerateOverlapEvents(true);
+
+	// Weapons hit the capsules of `Hitboxes`, not the mesh.
+	GetMesh()->SetGenerateOverlapEvents(false);
 
 	// Create & attach health bar to root component of class
 	HealthBarComponent = CreateDefaultSubobject<UHealthBarComponent>(TEXT("HealthBar"));
@@ -31,45 +45,43 @@ AEnemy::AEnemy()
 	bUseControllerRotationYaw = false;
 	bUseControllerRotationRoll = false;
 
-	PawnSensing = CreateDefaultSubobject<UPawnSensingComponent>(TEXT("PawnSensing"));
-	PawnSensing->SightRadius = 4000.0f;
-	PawnSensing->SetPeripheralVisionAngle(45.0f);
+	// Enemies spawned by `UEnemyPoolSubsystem` need a controller as much as placed ones.
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
 }
 
 void AEnemy::Tick(float DeltaTime)
 {
-	Super::Tick(DeltaTime);
+	SLASH_PERF_SCOPE(ESPS_EnemyTick);
+	SLASH_PERF_SCOPE(ESPS_EnemyAI);
+	SLASH_PERF_COUNT(ESPS_EnemyAI, 1);
 
-	if (IsDead()) return;
+	Super::Tick(DeltaTime);
 
-	if (EnemyState > EEnemyState::EES_Patrolling)
-	{
-		CheckCombatTarget();
-	}
-	else
-	{
-		CheckPatrolTarget();
-	}
+	// Only reached when `slash.AI.BatchEnemyTick` is 0, otherwise `UEnemyAISubsystem` drives the AI.
+	UpdateAI();
 }
 
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	HandleDamage(DamageAmount);
 
-	CombatTarget = EventInstigator->GetPawn();
-
-	if (IsInsideAttackRadius())
-	{
-		EnemyState = EEnemyState::EES_Attacking;
-	}
-	else if (IsOutsideAttackRadius())
+	if (!IsDead() && EventInstigator)
 	{
-		ChaseTarget();
+		SetCombatTarget(EventInstigator->GetPawn());
+		HandleEnemyEvent(EEnemyEvent::EEE_Damaged);
 	}
 
 	return DamageAmount;
 }
 
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetCombatTarget(nullptr);
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AEnemy::Destroyed()
 {
 	// Remove the weapon equipped by Enemy
@@ -94,7 +106,7 @@ void AEnemy::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 
 	if (IsInsideAttackRadius() && !IsDead())
 	{
-		StartAttackTimer();
+		RequestAttack();
 	}
 }
 
@@ -102,26 +114,43 @@ void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (PawnSensing)
-	{
-		// Add binding to `PawnSensing` component
-		PawnSensing->OnSeePawn.AddDynamic(this, &AEnemy::PawnSeen);
-	}
-
 	InitializeEnemy();
 
 	Tags.Add(FName("Enemy"));
+
+	DefaultCapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
+	DefaultMeshCollision = GetMesh()->GetCollisionEnabled();
+
+	RegisterWithSubsystems();
+
+	// Drops are spawned ahead of time, dying only has to reuse them.
+	if (UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>())
+	{
+		PickupPool->PrewarmPickups(SoulClass);
+		PickupPool->PrewarmPickups(HealthClass);
+	}
 }
 
 void AEnemy::Die_Implementation()
 {
 	Super::Die_Implementation();
 
-	EnemyState = EEnemyState::EES_Dead;
+	SetEnemyState(EEnemyState::EES_Dead);
 	ClearAttackTimer();
+	ClearPatrolTimer();
+	SetCombatTarget(nullptr);
 	HideHealthBar();
 	DisableCapsule();
-	SetLifeSpan(DeathLifeSpan);
+
+	// With pooling, the enemy is recycled instead of destroyed once its life span is over.
+	if (UEnemyPoolSubsystem::IsPoolingEnabled())
+	{
+		GetWorldTimerManager().SetTimer(DeathLifeSpanTimer, this, &AEnemy::DeathLifeSpanFinished, DeathLifeSpan);
+	}
+	else
+	{
+		SetLifeSpan(DeathLifeSpan);
+	}
 
 	// To avoid rotating towards direction of acceleration after playing death montage.
 	GetCharacterMovement()->bOrientRotationToMovement = false;
@@ -129,10 +158,9 @@ void AEnemy::Die_Implementation()
 	// Disable weapon collision.
 	SetWeaponCollisionEnabled(ECollisionEnabled::NoCollision);
 
-	// Disable mesh collision & overlap events to avoid hitting again
-	// and spawning more than one soul/health at once.
+	// Disable mesh collision, dead enemies' hitboxes aren't activated anymore to avoid hitting
+	// again and spawning more than one soul/health at once.
 	GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	GetMesh()->SetGenerateOverlapEvents(false);
 
 	// Spawn a Soul once this enemy dies.
 	SpawnSoul();
@@ -143,40 +171,54 @@ void AEnemy::Die_Implementation()
 
 void AEnemy::SpawnSoul()
 {
-	UWorld* World = GetWorld();
-	if (World && SoulClass && Attributes)
+	SCOPE_CYCLE_COUNTER(STAT_EnemyDropSpawns);
+	SLASH_PERF_SCOPE(ESPS_Spawns);
+
+	UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool && SoulClass && Attributes)
 	{
 		const FVector SpawnLocation = GetActorLocation() + FVector(0.0f, 0.0f, 125.0f);
-		ASoul* SpawnedSoul = World->SpawnActor<ASoul>(SoulClass, SpawnLocation, GetActorRotation());
-		if (SpawnedSoul)
+		const int32 Souls = Attributes->GetSouls();
+
+		// Owned by this enemy, so the soul's ground trace ignores it.
+		PickupPool->AcquirePickup<ASoul>(SoulClass, FTransform(GetActorRotation(), SpawnLocation), this, [Souls](ASoul* SpawnedSoul)
 		{
-			SpawnedSoul->SetSouls(Attributes->GetSouls());
-			SpawnedSoul->SetOwner(this);
-		}
+			SpawnedSoul->SetSouls(Souls);
+		});
+		SLASH_PERF_COUNT(ESPS_Spawns, 1);
 	}
 }
 
 void AEnemy::SpawnHealth()
 {
-	UWorld* World = GetWorld();
-	if (World && HealthClass && Attributes && Attributes->GetSpawnableHealth() > 0)
+	SCOPE_CYCLE_COUNTER(STAT_EnemyDropSpawns);
+	SLASH_PERF_SCOPE(ESPS_Spawns);
+
+	UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool && HealthClass && Attributes && Attributes->GetSpawnableHealth() > 0)
 	{
 		const FVector SpawnLocation = GetActorLocation() + FVector(-100.0f, 80.0f, 0.0f);
+		const float HealthCount = Attributes->GetSpawnableHealth();
 
-		AHealth* SpawnedHealth = World->SpawnActor<AHealth>(HealthClass, SpawnLocation, GetActorRotation());
-		if (SpawnedHealth)
+		PickupPool->AcquirePickup<AHealth>(HealthClass, FTransform(GetActorRotation(), SpawnLocation), nullptr, [HealthCount](AHealth* SpawnedHealth)
 		{
-			SpawnedHealth->SetHealthCount(Attributes->GetSpawnableHealth());
-		}
+			SpawnedHealth->SetHealthCount(HealthCount);
+		});
+		SLASH_PERF_COUNT(ESPS_Spawns, 1);
 	}
 }
 
 void AEnemy::Attack()
 {
 	Super::Attack();
-	if (CombatTarget == nullptr) return;
+	if (CombatTarget == nullptr)
+	{
+		// The target died before the swing, `Super::Attack()` already dropped it.
+		HandleEnemyEvent(EEnemyEvent::EEE_TargetDied);
+		return;
+	}
 
-	EnemyState = EEnemyState::EES_Engaged;
+	SetEnemyState(EEnemyState::EES_Engaged);
 	PlayAttackMontage();
 }
 
@@ -193,8 +235,7 @@ bool AEnemy::CanAttack()
 
 void AEnemy::AttackEnd()
 {
-	EnemyState = EEnemyState::EES_NoState;
-	CheckCombatTarget();
+	HandleEnemyEvent(EEnemyEvent::EEE_AttackEnded);
 }
 
 void AEnemy::HandleDamage(float DamageAmount)
@@ -221,6 +262,10 @@ void AEnemy::TrySpawningRandomWeapon()
 	{
 		const FVector SpawnLocation = GetActorLocation() + FVector(100.0f, -80.0f, 0.0f);
 
+		SCOPE_CYCLE_COUNTER(STAT_EnemyDropSpawns);
+		SLASH_PERF_SCOPE(ESPS_Spawns);
+		SLASH_PERF_COUNT(ESPS_Spawns, 1);
+
 		const int32 Selection = FMath::RandRange(0, SpawnableRandomWeapons.Num() - 1);
 		World->SpawnActor<AWeapon>(
 			SpawnableRandomWeapons[Selection],
@@ -230,12 +275,181 @@ void AEnemy::TrySpawningRandomWeapon()
 	}
 }
 
+void AEnemy::SetEnemyState(EEnemyState NewState)
+{
+	EnemyState = NewState;
+
+	// Leaving the patrol, the enemy won't start the next move from a patrol target.
+	if (NewState != EEnemyState::EES_Patrolling)
+	{
+		PatrolOrigin = nullptr;
+	}
+
+	// Only orbiting enemies wait for an attack token, only fighting ones keep theirs.
+	if (AttackTokens)
+	{
+		if (NewState != EEnemyState::EES_Orbiting)
+		{
+			AttackTokens->CancelRequest(this);
+		}
+		if (!FEnemyStateMachine::CanHoldAttackToken(NewState))
+		{
+			AttackTokens->ReleaseToken(this);
+		}
+	}
+
+	// Only chasing & orbiting enemies are steered, attacking ones must stop pushing into the target.
+	if (PursuitSubsystem && NewState != EEnemyState::EES_Chasing && NewState != EEnemyState::EES_Orbiting)
+	{
+		PursuitSubsystem->StopPursuit(this);
+	}
+
+	// Re-check the combat target's range once after every transition.
+	RangeBand = EEnemyRangeBand::ERB_Unknown;
+
+	if (AISubsystem)
+	{
+		AISubsystem->SetEnemyState(this, NewState);
+	}
+}
+
+void AEnemy::DeactivateForPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	SetCombatTarget(nullptr);
+
+	if (EnemyController)
+	{
+		EnemyController->StopMovement();
+	}
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	UnregisterFromSubsystems();
+	SetActorTickEnabled(false);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->SetActorHiddenInGame(true);
+	}
+}
+
+void AEnemy::ResetFromPool(const FTransform& SpawnTransform)
+{
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	CombatFlags &= ~ECombatFlags::ECF_Dead;
+	Tags.Remove(FName("Dead"));
+	if (Attributes)
+	{
+		Attributes->ResetAttributes();
+	}
+	if (Attributes && HealthBarComponent)
+	{
+		HealthBarComponent->SetHealthPercent(Attributes->GetHealthPercent());
+	}
+	HideHealthBar();
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultCapsuleCollision);
+	GetMesh()->SetCollisionEnabled(DefaultMeshCollision);
+
+	GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
+	GetCharacterMovement()->bOrientRotationToMovement = true;
+	GetCharacterMovement()->MaxWalkSpeed = PatrollingSpeed;
+
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->SetActorHiddenInGame(false);
+	}
+	SetWeaponCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// The controller normally stays possessed while pooled, only replace it if it went away.
+	if (GetController() == nullptr)
+	{
+		SpawnDefaultController();
+	}
+	InitializeController();
+
+	RegisterWithSubsystems();
+	SetEnemyState(EEnemyState::EES_Patrolling);
+
+	PatrolOrigin = nullptr;
+	if (PatrolTarget == nullptr)
+	{
+		PatrolTarget = ChoosePatrolTarget();
+	}
+	MoveToPatrolTarget();
+}
+
+void AEnemy::SetPatrolTargets(const TArray<AActor*>& NewPatrolTargets)
+{
+	PatrolTargets = NewPatrolTargets;
+	PatrolOrigin = nullptr;
+	PatrolTarget = ChoosePatrolTarget();
+
+	if (PatrolRoutes)
+	{
+		PatrolRoutes->RegisterRoute(PatrolTargets, GetNavAgentPropertiesRef());
+	}
+
+	if (EnemyState == EEnemyState::EES_Patrolling && !GetWorldTimerManager().IsTimerActive(PatrolTimer))
+	{
+		MoveToPatrolTarget();
+	}
+}
+
+void AEnemy::RestoreCrowdState(const TArray<AActor*>& NewPatrolTargets, AActor* CurrentPatrolTarget, float Health, float WaitTime)
+{
+	PatrolTargets = NewPatrolTargets;
+	PatrolOrigin = nullptr;
+	PatrolTarget = CurrentPatrolTarget ? CurrentPatrolTarget : ChoosePatrolTarget();
+
+	if (PatrolRoutes)
+	{
+		PatrolRoutes->RegisterRoute(PatrolTargets, GetNavAgentPropertiesRef());
+	}
+
+	if (Attributes)
+	{
+		Attributes->SetHealth(Health);
+	}
+	if (Attributes && HealthBarComponent)
+	{
+		HealthBarComponent->SetHealthPercent(Attributes->GetHealthPercent());
+	}
+
+	if (EnemyState != EEnemyState::EES_Patrolling) return;
+
+	if (WaitTime > 0.0f)
+	{
+		// The proxy was waiting at its previous patrol target, keep waiting for the rest of it.
+		if (EnemyController)
+		{
+			EnemyController->StopMovement();
+		}
+		GetWorldTimerManager().SetTimer(PatrolTimer, this, &AEnemy::PatrolTimerFinished, WaitTime);
+	}
+	else
+	{
+		MoveToPatrolTarget();
+	}
+}
+
 void AEnemy::InitializeEnemy()
 {
-	EnemyController = Cast<AAIController>(GetController());
+	InitializeController();
 
 	// Move enemy to the `PatrolTarget`
-	MoveToTarget(PatrolTarget);
+	MoveToPatrolTarget();
 
 	// Hide health bar in the beginning
 	HideHealthBar();
@@ -244,48 +458,330 @@ void AEnemy::InitializeEnemy()
 	SpawnDefaultWeapon();
 }
 
-void AEnemy::CheckPatrolTarget()
+void AEnemy::InitializeController()
 {
-	if (InTargetRange(PatrolTarget, PatrolRadius))
+	EnemyController = Cast<AAIController>(GetController());
+	if (EnemyController)
 	{
-		// Set new patrol target after reaching the current target
-		PatrolTarget = ChoosePatrolTarget();
+		// Reaching a patrol target is reported by path following, no need to poll the distance.
+		// Bound to the path following component itself, the controller's delegate drops the result flags.
+		if (UPathFollowingComponent* PathFollowing = EnemyController->GetPathFollowingComponent())
+		{
+			PathFollowing->OnRequestFinished.RemoveAll(this);
+			PathFollowing->OnRequestFinished.AddUObject(this, &AEnemy::OnMoveCompleted);
+		}
+	}
+}
 
-		// Set timer to wait for random seconds between `WaitMin` & `WaitMax`
-		// then use callback to move enemy to the new target after timer elapsed
-		const float WaitTime = FMath::RandRange(PatrolWaitMin, PatrolWaitMax);
-		GetWorldTimerManager().SetTimer(PatrolTimer, this, &AEnemy::PatrolTimerFinished, WaitTime);
+void AEnemy::RegisterWithSubsystems()
+{
+	SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	if (SpatialHash)
+	{
+		SpatialHash->RegisterActor(this, ESpatialCategory::ESC_Enemy);
+	}
+
+	// Hand over the per-frame AI update to the world's batch subsystem.
+	AISubsystem = GetWorld()->GetSubsystem<UEnemyAISubsystem>();
+	if (AISubsystem)
+	{
+		AISubsystem->RegisterEnemy(this);
+	}
+
+	PursuitSubsystem = GetWorld()->GetSubsystem<UPursuitFlowFieldSubsystem>();
+	AttackTokens = GetWorld()->GetSubsystem<UAttackTokenSubsystem>();
+
+	// Placed enemies too, so they become crowd proxies once every player is far away.
+	Crowd = GetWorld()->GetSubsystem<UEnemyCrowdSubsystem>();
+	if (Crowd)
+	{
+		Crowd->RegisterEnemy(this);
+	}
+
+	// Paths between the patrol targets are computed once, when the level starts.
+	PatrolRoutes = GetWorld()->GetSubsystem<UPatrolRouteSubsystem>();
+	if (PatrolRoutes)
+	{
+		PatrolRoutes->RegisterRoute(PatrolTargets, GetNavAgentPropertiesRef());
 	}
 }
 
-void AEnemy::CheckCombatTarget()
+void AEnemy::UnregisterFromSubsystems()
 {
-	if (IsOutsideCombatRadius())
+	if (AttackTokens)
 	{
-		ClearAttackTimer();
-		LoseInterest();
-		if (!IsEngaged())
-		{
-			StartPatrolling();
-		}
+		AttackTokens->CancelRequest(this);
+		AttackTokens->ReleaseToken(this);
+	}
+
+	if (PursuitSubsystem)
+	{
+		PursuitSubsystem->StopPursuit(this);
+	}
+
+	if (AISubsystem)
+	{
+		AISubsystem->UnregisterEnemy(this);
+		AISubsystem = nullptr;
 	}
-	else if (IsOutsideAttackRadius() && !IsChasing())
+
+	if (Crowd)
 	{
-		ClearAttackTimer();
-		if (!IsEngaged())
+		Crowd->UnregisterEnemy(this);
+		Crowd = nullptr;
+	}
+
+	if (SpatialHash)
+	{
+		SpatialHash->UnregisterActor(this);
+	}
+}
+
+void AEnemy::DeathLifeSpanFinished()
+{
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if (EnemyPool)
+	{
+		EnemyPool->ReleaseEnemy(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AEnemy::UpdateAI()
+{
+	SLASH_PERF_SCOPE(ESPS_CombatRangeChecks);
+
+	if (!FEnemyStateMachine::IsRangeWatchedState(EnemyState)) return;
+
+	const EEnemyRangeBand NewBand = ComputeRangeBand();
+	if (NewBand != RangeBand)
+	{
+		OnRangeBandChanged(NewBand);
+	}
+}
+
+AActor* AEnemy::GetAITarget() const
+{
+	return FEnemyStateMachine::IsRangeWatchedState(EnemyState) ? CombatTarget : PatrolTarget;
+}
+
+void AEnemy::HandleEnemyEvent(EEnemyEvent Event)
+{
+	const FEnemyStateMachine::FTransition Transition = FEnemyStateMachine::GetTransition(EnemyState, Event);
+	if (Transition == nullptr) return;
+
+	(this->*Transition)();
+
+	if (AISubsystem)
+	{
+		AISubsystem->NotifyTransitionProcessed();
+	}
+}
+
+void AEnemy::OnRangeBandChanged(EEnemyRangeBand NewBand)
+{
+	RangeBand = NewBand;
+	HandleEnemyEvent(FEnemyStateMachine::GetRangeBandEvent(NewBand));
+}
+
+EEnemyRangeBand AEnemy::ComputeRangeBand()
+{
+	if (IsInsideAttackRadius())
+	{
+		return EEnemyRangeBand::ERB_InsideAttackRadius;
+	}
+	if (!IsOutsideCombatRadius())
+	{
+		return EEnemyRangeBand::ERB_InsideCombatRadius;
+	}
+	return EEnemyRangeBand::ERB_OutsideCombatRadius;
+}
+
+void AEnemy::SetCombatTarget(AActor* NewTarget)
+{
+	if (NewTarget == nullptr && PursuitSubsystem)
+	{
+		PursuitSubsystem->StopPursuit(this);
+	}
+
+	CombatTarget = NewTarget;
+
+	ABaseCharacter* NewCharacter = Cast<ABaseCharacter>(NewTarget);
+	if (ObservedCombatTarget.Get() == NewCharacter) return;
+
+	if (ABaseCharacter* OldCharacter = ObservedCombatTarget.Get())
+	{
+		OldCharacter->OnCharacterDied.Remove(CombatTargetDiedHandle);
+	}
+	CombatTargetDiedHandle.Reset();
+	ObservedCombatTarget = NewCharacter;
+
+	if (NewCharacter)
+	{
+		CombatTargetDiedHandle = NewCharacter->OnCharacterDied.AddUObject(this, &AEnemy::OnCombatTargetDied);
+	}
+}
+
+void AEnemy::OnCombatTargetDied(ABaseCharacter* DeadCharacter)
+{
+	if (DeadCharacter != CombatTarget) return;
+
+	HandleEnemyEvent(EEnemyEvent::EEE_TargetDied);
+}
+
+void AEnemy::OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+	if (Result.IsAborted())
+	{
+		// A path invalidated under a patrolling enemy (navmesh tile rebuilt & no new path found)
+		// isn't replaced by anything, walk to the patrol target again from here.
+		if (EnemyState == EEnemyState::EES_Patrolling &&
+			Result.HasFlag(FPathFollowingResultFlags::InvalidPath) &&
+			!Result.HasFlag(FPathFollowingResultFlags::NewRequest))
 		{
-			ChaseTarget();
+			PatrolOrigin = nullptr;
+			MoveToPatrolTarget();
 		}
+
+		// Other aborted moves were replaced by a newer request, e.g. the start of a chase.
+		return;
 	}
-	else if (CanAttack())
+
+	if (EnemyState == EEnemyState::EES_Patrolling)
 	{
-		StartAttackTimer();
+		// Only a patrol target actually reached can start a cached path.
+		PatrolOrigin = Result.IsSuccess() ? PatrolTarget : nullptr;
 	}
+
+	// Blocked or invalid paths still move on to the next waypoint, so the patrol can't get stuck.
+	HandleEnemyEvent(EEnemyEvent::EEE_PatrolTargetReached);
 }
 
 void AEnemy::PatrolTimerFinished()
 {
-	MoveToTarget(PatrolTarget);
+	HandleEnemyEvent(EEnemyEvent::EEE_PatrolTimerExpired);
+}
+
+void AEnemy::AttackTimerFinished()
+{
+	HandleEnemyEvent(EEnemyEvent::EEE_AttackTimerExpired);
+}
+
+void AEnemy::OnTargetSeen()
+{
+	// Clear the `PatrolTimer` once started chasing the character
+	ClearPatrolTimer();
+
+	// Chase target.
+	ChaseTarget();
+}
+
+void AEnemy::OnPatrolTargetReached()
+{
+	// Set new patrol target after reaching the current target
+	PatrolTarget = ChoosePatrolTarget();
+
+	// Set timer to wait for random seconds between `WaitMin` & `WaitMax`
+	// then use callback to move enemy to the new target after timer elapsed
+	const float WaitTime = FMath::RandRange(PatrolWaitMin, PatrolWaitMax);
+	GetWorldTimerManager().SetTimer(PatrolTimer, this, &AEnemy::PatrolTimerFinished, WaitTime);
+}
+
+void AEnemy::ResumePatrol()
+{
+	MoveToPatrolTarget();
+}
+
+void AEnemy::ChaseFromAttack()
+{
+	ClearAttackTimer();
+	ChaseTarget();
+}
+
+void AEnemy::GiveUpCombat()
+{
+	ClearAttackTimer();
+	LoseInterest();
+	StartPatrolling();
+}
+
+void AEnemy::LoseInterestWhileEngaged()
+{
+	// Let the running attack finish, `FinishAttack()` goes back to patrolling afterwards.
+	ClearAttackTimer();
+	LoseInterest();
+}
+
+void AEnemy::FinishAttack()
+{
+	SetEnemyState(EEnemyState::EES_NoState);
+
+	// Decide right away what to do next, based on where the combat target is now.
+	OnRangeBandChanged(ComputeRangeBand());
+}
+
+void AEnemy::OnDamaged()
+{
+	ClearPatrolTimer();
+
+	if (IsInsideAttackRadius())
+	{
+		RequestAttack();
+	}
+	else
+	{
+		ChaseTarget();
+	}
+}
+
+void AEnemy::RequestAttack()
+{
+	if (AttackTokens == nullptr || AttackTokens->RequestToken(this, CombatTarget))
+	{
+		StartAttackTimer();
+	}
+	else
+	{
+		StartOrbiting();
+	}
+}
+
+void AEnemy::AttackFromOrbit()
+{
+	// The token is kept while closing in, see `FEnemyStateMachine::CanHoldAttackToken()`.
+	if (IsInsideAttackRadius())
+	{
+		StartAttackTimer();
+	}
+	else
+	{
+		ChaseTarget();
+	}
+}
+
+void AEnemy::OnAttackTokenGranted()
+{
+	HandleEnemyEvent(EEnemyEvent::EEE_AttackTokenGranted);
+}
+
+void AEnemy::StartOrbiting()
+{
+	ClearAttackTimer();
+	SetEnemyState(EEnemyState::EES_Orbiting);
+	GetCharacterMovement()->MaxWalkSpeed = PatrollingSpeed;
+
+	// Circling around the target is steered by the pursuit subsystem, otherwise just hold position.
+	if (PursuitSubsystem && UPursuitFlowFieldSubsystem::IsFlowFieldPursuitEnabled())
+	{
+		PursuitSubsystem->StartPursuit(this, CombatTarget);
+	}
+	else if (EnemyController)
+	{
+		EnemyController->StopMovement();
+	}
 }
 
 void AEnemy::HideHealthBar()
@@ -307,7 +803,7 @@ void AEnemy::ShowHealthBar()
 void AEnemy::LoseInterest()
 {
 	// Outside the combat radius, then no combat target
-	CombatTarget = nullptr;
+	SetCombatTarget(nullptr);
 
 	// Hide health bar
 	HideHealthBar();
@@ -316,20 +812,28 @@ void AEnemy::LoseInterest()
 void AEnemy::StartPatrolling()
 {
 	// Reset the enemy state to patrolling
-	EnemyState = EEnemyState::EES_Patrolling;
+	SetEnemyState(EEnemyState::EES_Patrolling);
 
 	// Reset the max walk speed to speed of walking as per created in Blend Space 1D Horizontal Axis
 	GetCharacterMovement()->MaxWalkSpeed = PatrollingSpeed;
 
 	// Set movement back to `PatrolTarget`
-	MoveToTarget(PatrolTarget);
+	MoveToPatrolTarget();
 }
 
 void AEnemy::ChaseTarget()
 {
-	EnemyState = EEnemyState::EES_Chasing;
+	SetEnemyState(EEnemyState::EES_Chasing);
 	GetCharacterMovement()->MaxWalkSpeed = ChasingSpeed;
-	MoveToTarget(CombatTarget);
+
+	if (PursuitSubsystem && UPursuitFlowFieldSubsystem::IsFlowFieldPursuitEnabled())
+	{
+		PursuitSubsystem->StartPursuit(this, CombatTarget);
+	}
+	else
+	{
+		MoveToTarget(CombatTarget);
+	}
 }
 
 bool AEnemy::IsOutsideCombatRadius()
@@ -367,6 +871,11 @@ bool AEnemy::IsEngaged()
 	return EnemyState == EEnemyState::EES_Engaged;
 }
 
+bool AEnemy::IsOrbiting()
+{
+	return EnemyState == EEnemyState::EES_Orbiting;
+}
+
 void AEnemy::ClearPatrolTimer()
 {
 	GetWorldTimerManager().ClearTimer(PatrolTimer);
@@ -374,9 +883,9 @@ void AEnemy::ClearPatrolTimer()
 
 void AEnemy::StartAttackTimer()
 {
-	EnemyState = EEnemyState::EES_Attacking;
+	SetEnemyState(EEnemyState::EES_Attacking);
 	const float AttackTime = FMath::RandRange(AttackMin, AttackMax);
-	GetWorldTimerManager().SetTimer(AttackTimer, this, &AEnemy::Attack, AttackTime);
+	GetWorldTimerManager().SetTimer(AttackTimer, this, &AEnemy::AttackTimerFinished, AttackTime);
 }
 
 void AEnemy::ClearAttackTimer()
@@ -388,14 +897,19 @@ bool AEnemy::InTargetRange(AActor* Target, double Radius)
 {
 	if (Target == nullptr) return false;
 
-	// Calculate the distance between enemy & specified target
-	const double DistanceToTarget = (Target->GetActorLocation() - GetActorLocation()).Size();
+	// Compare squared distance between enemy & specified target, using locations cached for this frame.
+	if (SpatialHash)
+	{
+		return SpatialHash->IsWithinRange(this, Target, Radius);
+	}
 
-	return DistanceToTarget <= Radius;
+	return FVector::DistSquared(Target->GetActorLocation(), GetActorLocation()) <= FMath::Square(Radius);
 }
 
 void AEnemy::MoveToTarget(AActor* Target)
 {
+	SLASH_PERF_SCOPE(ESPS_MoveToTarget);
+
 	if (EnemyController == nullptr || Target == nullptr) return;
 
 	FAIMoveRequest MoveRequest;
@@ -405,27 +919,48 @@ void AEnemy::MoveToTarget(AActor* Target)
 	EnemyController->MoveTo(MoveRequest);
 }
 
-AActor* AEnemy::ChoosePatrolTarget()
+void AEnemy::MoveToPatrolTarget()
 {
-	// To eliminate possibility of selecting the same target in random selection,
-	// create temporary array of valid targets containing all targets except the current one.
-	TArray<AActor*> ValidTargets;
-	for (AActor* Target : PatrolTargets)
+	if (EnemyController == nullptr || PatrolTarget == nullptr) return;
+
+	// Between two patrol targets, replay the cached path instead of pathfinding again.
+	FNavPathSharedPtr CachedPath;
+	if (PatrolRoutes && PatrolOrigin)
 	{
-		if (Target != PatrolTarget)
-		{
-			ValidTargets.AddUnique(Target);
-		}
+		CachedPath = PatrolRoutes->FindPath(PatrolOrigin, PatrolTarget, GetNavAgentPropertiesRef());
 	}
 
-	const int32 NumPatrolTargets = ValidTargets.Num();
-	if (NumPatrolTargets > 0)
+	if (!CachedPath.IsValid())
 	{
-		const int32 TargetSelection = FMath::RandRange(0, NumPatrolTargets - 1);
-		return ValidTargets[TargetSelection];
+		MoveToTarget(PatrolTarget);
+		return;
 	}
 
-	return nullptr;
+	SLASH_PERF_SCOPE(ESPS_MoveToTarget);
+
+	FAIMoveRequest MoveRequest;
+	MoveRequest.SetGoalLocation(PatrolTarget->GetActorLocation());
+	MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
+
+	EnemyController->RequestMove(MoveRequest, CachedPath);
+}
+
+AActor* AEnemy::ChoosePatrolTarget()
+{
+	// Pick uniformly among all targets except the current one, without building a temporary array:
+	// draw from one less slot & skip over the current target's index.
+	const int32 NumPatrolTargets = PatrolTargets.Num();
+	const int32 CurrentIndex = PatrolTargets.IndexOfByKey(PatrolTarget);
+	const int32 NumCandidates = CurrentIndex == INDEX_NONE ? NumPatrolTargets : NumPatrolTargets - 1;
+	if (NumCandidates <= 0) return nullptr;
+
+	int32 TargetSelection = FMath::RandRange(0, NumCandidates - 1);
+	if (CurrentIndex != INDEX_NONE && TargetSelection >= CurrentIndex)
+	{
+		TargetSelection++;
+	}
+
+	return PatrolTargets[TargetSelection];
 }
 
 void AEnemy::SpawnDefaultWeapon()
@@ -433,7 +968,15 @@ void AEnemy::SpawnDefaultWeapon()
 	UWorld* World = GetWorld();
 	if (World && WeaponClass)
 	{
-		AWeapon* DefaultWeapon = World->SpawnActor<AWeapon>(WeaponClass);
+		// Spawned with its owner, so it doesn't set itself up as a pickup.
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = this;
+		SpawnParameters.Instigator = this;
+
+		SLASH_PERF_SCOPE(ESPS_Spawns);
+		SLASH_PERF_COUNT(ESPS_Spawns, 1);
+
+		AWeapon* DefaultWeapon = World->SpawnActor<AWeapon>(WeaponClass, SpawnParameters);
 		DefaultWeapon->Equip(GetMesh(), FName("WeaponSocket"), this, this);
 		EquippedWeapon = DefaultWeapon;
 	}
@@ -442,21 +985,14 @@ void AEnemy::SpawnDefaultWeapon()
 void AEnemy::PawnSeen(APawn* SeenPawn)
 {
 	const bool bShouldChaseTarget =
-		EnemyState != EEnemyState::EES_Dead &&
-		EnemyState != EEnemyState::EES_Chasing &&
-		EnemyState < EEnemyState::EES_Attacking &&
-		SeenPawn->ActorHasTag(FName("EngageableTarget")) &&
-		!(SeenPawn->ActorHasTag(FName("Dead")));
+		FEnemyStateMachine::HasTransition(EnemyState, EEnemyEvent::EEE_TargetSeen) &&
+		(GetCombatFlags(SeenPawn) & (ECombatFlags::ECF_EngageableTarget | ECombatFlags::ECF_Dead)) == ECombatFlags::ECF_EngageableTarget;
 
 	if (bShouldChaseTarget)
 	{
 		// Set the `CombatTarget` to `SeenPawn`
-		CombatTarget = SeenPawn;
+		SetCombatTarget(SeenPawn);
 
-		// Clear the `PatrolTimer` once started chasing the character
-		ClearPatrolTimer();
-
-		// Chase target.
-		ChaseTarget();
+		HandleEnemyEvent(EEnemyEvent::EEE_TargetSeen);
 	}
 }
@@ -0,0 +1,446 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyAISubsystem.h"
+#include "Enemy/Enemy.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy AI Batch Tick"), STAT_EnemyAIBatchTick, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Enemy AI Significance"), STAT_EnemyAISignificance, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Enemy AI Gather"), STAT_EnemyAIGather, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Enemy AI Evaluate"), STAT_EnemyAIEvaluate, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Enemy AI Dispatch"), STAT_EnemyAIDispatch, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies"), STAT_NumEnemies, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy AI Updates"), STAT_EnemyAIUpdates, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy AI Range Events"), STAT_EnemyAIRangeEvents, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy State Transitions"), STAT_EnemyStateTransitions, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy State Transitions / s"), STAT_EnemyStateTransitionsPerSecond, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Enemies"), STAT_NumDormantEnemies, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<int32> CVarBatchEnemyTick(
+	TEXT("slash.AI.BatchEnemyTick"),
+	1,
+	TEXT("1: Update all enemies from UEnemyAISubsystem in one loop (default).\n")
+	TEXT("0: Every enemy runs its own AEnemy::Tick (reference path for frame time comparison)."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarLODNearDistance(
+	TEXT("slash.AI.LOD.NearDistance"),
+	3000.0f,
+	TEXT("Enemies closer than this to a player are updated every frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarLODMidDistance(
+	TEXT("slash.AI.LOD.MidDistance"),
+	6000.0f,
+	TEXT("Enemies closer than this to a player are updated every 4th frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarLODFarDistance(
+	TEXT("slash.AI.LOD.FarDistance"),
+	12000.0f,
+	TEXT("Enemies closer than this to a player are updated every 15th frame, the rest go dormant."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarLODUpdateInterval(
+	TEXT("slash.AI.LOD.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between re-evaluations of enemy update rate buckets."),
+	ECVF_Default
+);
+
+namespace
+{
+	// Number of frames between two AI updates of the bucket, 0 = never updated.
+	uint8 GetLODFrameInterval(EEnemyAILOD LOD)
+	{
+		switch (LOD)
+		{
+		case EEnemyAILOD::EAL_EveryFrame:
+			return 1;
+		case EEnemyAILOD::EAL_Every4thFrame:
+			return 4;
+		case EEnemyAILOD::EAL_Every15thFrame:
+			return 15;
+		default:
+			return 0;
+		}
+	}
+}
+
+void UEnemyAISubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAIBatchTick);
+	SLASH_PERF_SCOPE(ESPS_EnemyAIBatchTick);
+	SLASH_PERF_SCOPE(ESPS_EnemyAI);
+	SET_DWORD_STAT(STAT_NumEnemies, Enemies.Num());
+
+	TransitionsCountdown -= DeltaTime;
+	if (TransitionsCountdown <= 0.0f)
+	{
+		TransitionsCountdown += 1.0f;
+		TransitionsPerSecond = TransitionsThisSecond;
+		TransitionsThisSecond = 0;
+		SET_DWORD_STAT(STAT_EnemyStateTransitionsPerSecond, TransitionsPerSecond);
+	}
+
+	// Switch between batched & per-actor updates when the console variable changes at runtime.
+	const bool bBatchTick = IsBatchTickEnabled();
+	if (bBatchTick != bBatchTickActive)
+	{
+		bBatchTickActive = bBatchTick;
+		SetEnemyTicksEnabled(!bBatchTickActive);
+	}
+
+	if (!bBatchTickActive) return;
+
+	SignificanceCountdown -= DeltaTime;
+	if (SignificanceCountdown <= 0.0f)
+	{
+		SignificanceCountdown = CVarLODUpdateInterval.GetValueOnGameThread();
+		UpdateSignificance();
+	}
+
+	ScheduleUpdates();
+	GatherEnemyLocations();
+	EvaluateEnemies();
+	DispatchDecisions();
+}
+
+TStatId UEnemyAISubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyAISubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyAISubsystem::Deinitialize()
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+		{
+			Enemy->AISlot = INDEX_NONE;
+		}
+	}
+	Enemies.Empty();
+	States.Empty();
+	Locations.Empty();
+	TargetLocations.Empty();
+	HasTarget.Empty();
+	RangeBands.Empty();
+	CombatRadiiSquared.Empty();
+	AttackRadiiSquared.Empty();
+	LODs.Empty();
+	FramesUntilUpdate.Empty();
+	DueEnemies.Empty();
+	PendingDecisions.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyAISubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Enemy->AISlot != INDEX_NONE) return;
+
+	Enemy->AISlot = Enemies.Add(Enemy);
+	States.Add(Enemy->EnemyState);
+	Locations.Add(Enemy->GetActorLocation());
+	TargetLocations.Add(FVector::ZeroVector);
+	HasTarget.Add(false);
+	RangeBands.Add(EEnemyRangeBand::ERB_Unknown);
+	CombatRadiiSquared.Add(FMath::Square(Enemy->CombatRadius));
+	AttackRadiiSquared.Add(FMath::Square(Enemy->AttackRadius));
+
+	// Start at full rate, the next significance pass moves the enemy into its real bucket.
+	LODs.Add(EEnemyAILOD::EAL_EveryFrame);
+	FramesUntilUpdate.Add(0);
+
+	// Enemy's own tick is only used when batching is switched off.
+	Enemy->SetActorTickEnabled(!bBatchTickActive);
+}
+
+void UEnemyAISubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || !Enemies.IsValidIndex(Enemy->AISlot) || Enemies[Enemy->AISlot] != Enemy) return;
+
+	const int32 Slot = Enemy->AISlot;
+	Enemy->AISlot = INDEX_NONE;
+
+	Enemies.RemoveAtSwap(Slot, 1, false);
+	States.RemoveAtSwap(Slot, 1, false);
+	Locations.RemoveAtSwap(Slot, 1, false);
+	TargetLocations.RemoveAtSwap(Slot, 1, false);
+	HasTarget.RemoveAtSwap(Slot, 1, false);
+	RangeBands.RemoveAtSwap(Slot, 1, false);
+	CombatRadiiSquared.RemoveAtSwap(Slot, 1, false);
+	AttackRadiiSquared.RemoveAtSwap(Slot, 1, false);
+	LODs.RemoveAtSwap(Slot, 1, false);
+	FramesUntilUpdate.RemoveAtSwap(Slot, 1, false);
+
+	// The last enemy has been moved into the freed slot.
+	if (Enemies.IsValidIndex(Slot) && Enemies[Slot])
+	{
+		Enemies[Slot]->AISlot = Slot;
+	}
+}
+
+void UEnemyAISubsystem::SetEnemyState(const AEnemy* Enemy, EEnemyState NewState)
+{
+	if (Enemy && States.IsValidIndex(Enemy->AISlot))
+	{
+		const int32 Slot = Enemy->AISlot;
+		States[Slot] = NewState;
+
+		// Re-check the combat target's range once after every transition.
+		RangeBands[Slot] = EEnemyRangeBand::ERB_Unknown;
+
+		// An enemy entering combat reacts right away, whatever its current bucket.
+		if (FEnemyStateMachine::IsRangeWatchedState(NewState) && LODs[Slot] != EEnemyAILOD::EAL_EveryFrame)
+		{
+			LODs[Slot] = EEnemyAILOD::EAL_EveryFrame;
+			FramesUntilUpdate[Slot] = 0;
+		}
+	}
+}
+
+void UEnemyAISubsystem::NotifyTransitionProcessed()
+{
+	TransitionsThisSecond++;
+	INC_DWORD_STAT(STAT_EnemyStateTransitions);
+}
+
+EEnemyAILOD UEnemyAISubsystem::GetEnemyLOD(const AEnemy* Enemy) const
+{
+	return (Enemy && LODs.IsValidIndex(Enemy->AISlot)) ? LODs[Enemy->AISlot] : EEnemyAILOD::EAL_EveryFrame;
+}
+
+bool UEnemyAISubsystem::IsBatchTickEnabled()
+{
+	return CVarBatchEnemyTick.GetValueOnGameThread() != 0;
+}
+
+bool UEnemyAISubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyAISubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAISignificance);
+
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			PlayerLocations.Add(PlayerController->GetPawn()->GetActorLocation());
+		}
+	}
+
+	const double NearDistanceSquared = FMath::Square(CVarLODNearDistance.GetValueOnGameThread());
+	const double MidDistanceSquared = FMath::Square(CVarLODMidDistance.GetValueOnGameThread());
+	const double FarDistanceSquared = FMath::Square(CVarLODFarDistance.GetValueOnGameThread());
+
+	int32 NumDormant = 0;
+
+	const int32 NumEnemies = Enemies.Num();
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+	{
+		const AEnemy* Enemy = Enemies[Index];
+		if (Enemy == nullptr) continue;
+
+		Locations[Index] = Enemy->GetActorLocation();
+
+		double ClosestDistanceSquared = TNumericLimits<double>::Max();
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Locations[Index], PlayerLocation));
+		}
+
+		EEnemyAILOD LOD = EEnemyAILOD::EAL_Dormant;
+		if (ClosestDistanceSquared <= NearDistanceSquared)
+		{
+			LOD = EEnemyAILOD::EAL_EveryFrame;
+		}
+		else if (ClosestDistanceSquared <= MidDistanceSquared)
+		{
+			LOD = EEnemyAILOD::EAL_Every4thFrame;
+		}
+		else if (ClosestDistanceSquared <= FarDistanceSquared)
+		{
+			LOD = EEnemyAILOD::EAL_Every15thFrame;
+		}
+
+		// Enemies on screen are promoted by one bucket, so visible behaviour stays responsive.
+		const USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+		if (LOD != EEnemyAILOD::EAL_EveryFrame && Mesh && Mesh->WasRecentlyRendered(0.2f))
+		{
+			LOD = static_cast<EEnemyAILOD>(static_cast<uint8>(LOD) - 1);
+		}
+
+		// Enemies in combat must keep noticing when their target leaves, never let them sleep.
+		if (LOD == EEnemyAILOD::EAL_Dormant && FEnemyStateMachine::IsRangeWatchedState(States[Index]))
+		{
+			LOD = EEnemyAILOD::EAL_Every15thFrame;
+		}
+
+		if (LOD != LODs[Index])
+		{
+			LODs[Index] = LOD;
+
+			// Spread the updates of slower buckets across frames.
+			const uint8 FrameInterval = GetLODFrameInterval(LOD);
+			FramesUntilUpdate[Index] = (FrameInterval > 0) ? static_cast<uint8>(Index % FrameInterval) : 0;
+		}
+
+		if (LOD == EEnemyAILOD::EAL_Dormant)
+		{
+			NumDormant++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_NumDormantEnemies, NumDormant);
+}
+
+void UEnemyAISubsystem::ScheduleUpdates()
+{
+	DueEnemies.Reset();
+
+	const int32 NumEnemies = Enemies.Num();
+	for (int32 Index = 0; Index < NumEnemies; Index++)
+	{
+		// Patrolling & dead enemies only react to events, nothing to check for them.
+		if (!FEnemyStateMachine::IsRangeWatchedState(States[Index])) continue;
+
+		const uint8 FrameInterval = GetLODFrameInterval(LODs[Index]);
+		if (FrameInterval == 0) continue;
+
+		if (FramesUntilUpdate[Index] > 0)
+		{
+			FramesUntilUpdate[Index]--;
+			continue;
+		}
+
+		FramesUntilUpdate[Index] = FrameInterval - 1;
+		DueEnemies.Add(Index);
+	}
+
+	INC_DWORD_STAT_BY(STAT_EnemyAIUpdates, DueEnemies.Num());
+	SLASH_PERF_COUNT(ESPS_EnemyAI, DueEnemies.Num());
+}
+
+void UEnemyAISubsystem::GatherEnemyLocations()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAIGather);
+
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+
+	for (const int32 Index : DueEnemies)
+	{
+		const AEnemy* Enemy = Enemies[Index];
+		if (Enemy == nullptr || States[Index] == EEnemyState::EES_Dead)
+		{
+			HasTarget[Index] = false;
+			continue;
+		}
+
+		const AActor* Target = Enemy->GetAITarget();
+		HasTarget[Index] = Target != nullptr;
+
+		if (SpatialHash)
+		{
+			Locations[Index] = SpatialHash->GetCachedLocation(Enemy);
+			if (Target)
+			{
+				TargetLocations[Index] = SpatialHash->GetCachedLocation(Target);
+			}
+		}
+		else
+		{
+			Locations[Index] = Enemy->GetActorLocation();
+			if (Target)
+			{
+				TargetLocations[Index] = Target->GetActorLocation();
+			}
+		}
+	}
+}
+
+void UEnemyAISubsystem::EvaluateEnemies()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAIEvaluate);
+	SLASH_PERF_SCOPE(ESPS_CombatRangeChecks);
+
+	PendingDecisions.Reset();
+
+	// Only a change of range band raises an event, enemies whose target stays on the same side
+	// of their radii are left alone. A lower update rate just delays the event, patrol & attack
+	// waits run on world timers and keep their real duration.
+	for (const int32 Index : DueEnemies)
+	{
+		const double DistanceSquared = HasTarget[Index] ?
+			FVector::DistSquared(Locations[Index], TargetLocations[Index]) :
+			TNumericLimits<double>::Max();
+
+		EEnemyRangeBand Band = EEnemyRangeBand::ERB_OutsideCombatRadius;
+		if (DistanceSquared <= AttackRadiiSquared[Index])
+		{
+			Band = EEnemyRangeBand::ERB_InsideAttackRadius;
+		}
+		else if (DistanceSquared <= CombatRadiiSquared[Index])
+		{
+			Band = EEnemyRangeBand::ERB_InsideCombatRadius;
+		}
+
+		if (Band != RangeBands[Index])
+		{
+			RangeBands[Index] = Band;
+			PendingDecisions.Add(Index);
+		}
+	}
+}
+
+void UEnemyAISubsystem::DispatchDecisions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAIDispatch);
+	INC_DWORD_STAT_BY(STAT_EnemyAIRangeEvents, PendingDecisions.Num());
+
+	// Resolve indices to actors first, an event may unregister enemies & reorder the arrays.
+	TArray<TPair<AEnemy*, EEnemyRangeBand>, TInlineAllocator<32>> EnemiesToNotify;
+	EnemiesToNotify.Reserve(PendingDecisions.Num());
+	for (const int32 Index : PendingDecisions)
+	{
+		EnemiesToNotify.Emplace(Enemies[Index], RangeBands[Index]);
+	}
+
+	for (const TPair<AEnemy*, EEnemyRangeBand>& Pair : EnemiesToNotify)
+	{
+		if (IsValid(Pair.Key))
+		{
+			Pair.Key->OnRangeBandChanged(Pair.Value);
+		}
+	}
+}
+
+void UEnemyAISubsystem::SetEnemyTicksEnabled(bool bEnabled)
+{
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy)
+		{
+			Enemy->SetActorTickEnabled(bEnabled);
+		}
+	}
+}
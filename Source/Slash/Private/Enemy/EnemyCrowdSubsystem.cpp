@@ -0,0 +1,395 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyCrowdSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Components/AttributeComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationSystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Simulation"), STAT_CrowdSimulation, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Crowd Promotion"), STAT_CrowdPromotion, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Crowd Proxies"), STAT_CrowdProxies, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Crowd Promoted Enemies"), STAT_CrowdPromotedEnemies, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Promotions"), STAT_CrowdPromotions, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Demotions"), STAT_CrowdDemotions, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<float> CVarCrowdUpdateInterval(
+	TEXT("slash.AI.Crowd.UpdateInterval"),
+	0.2f,
+	TEXT("Seconds between two updates of the crowd proxies."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarCrowdPromoteDistance(
+	TEXT("slash.AI.Crowd.PromoteDistance"),
+	8000.0f,
+	TEXT("Crowd proxies closer than this to a player become real enemies."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarCrowdDemoteDistance(
+	TEXT("slash.AI.Crowd.DemoteDistance"),
+	10000.0f,
+	TEXT("Patrolling crowd enemies further than this from every player become proxies again.\n")
+	TEXT("Keep it above slash.AI.Crowd.PromoteDistance, so enemies don't flip every update."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarCrowdMaxPromotionsPerUpdate(
+	TEXT("slash.AI.Crowd.MaxPromotionsPerUpdate"),
+	8,
+	TEXT("Maximum number of proxies promoted to enemies per update, to spread the cost over frames."),
+	ECVF_Default
+);
+
+void UEnemyCrowdSubsystem::Tick(float DeltaTime)
+{
+	SLASH_PERF_SCOPE(ESPS_EnemyAI);
+	SET_DWORD_STAT(STAT_CrowdProxies, ProxyLocations.Num());
+	SET_DWORD_STAT(STAT_CrowdPromotedEnemies, PromotedEnemies.Num());
+
+	UpdateCountdown -= DeltaTime;
+	if (UpdateCountdown > 0.0f) return;
+
+	const float UpdateInterval = CVarCrowdUpdateInterval.GetValueOnGameThread();
+	const float SimulatedTime = UpdateInterval - UpdateCountdown;
+	UpdateCountdown = UpdateInterval;
+
+	GatherPlayerLocations();
+	SimulateProxies(SimulatedTime);
+	DemoteEnemies();
+	PromoteProxies();
+}
+
+TStatId UEnemyCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyCrowdSubsystem::Deinitialize()
+{
+	Routes.Empty();
+	ProxyClasses.Empty();
+	ProxyLocations.Empty();
+	ProxyRotations.Empty();
+	ProxyStates.Empty();
+	ProxyHealths.Empty();
+	ProxyRoutes.Empty();
+	ProxyWaypoints.Empty();
+	ProxyWaitTimes.Empty();
+	ProxySpeeds.Empty();
+	ProxyWaitRanges.Empty();
+	PromotedEnemies.Empty();
+	PromotedRoutes.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyCrowdSubsystem::AddEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform, const TArray<AActor*>& PatrolTargets)
+{
+	const AEnemy* EnemyDefaults = EnemyClass ? EnemyClass->GetDefaultObject<AEnemy>() : nullptr;
+	if (EnemyDefaults == nullptr) return;
+
+	const int32 Route = FindOrAddRoute(PatrolTargets);
+
+	ProxyClasses.Add(EnemyClass);
+	ProxyLocations.Add(SpawnTransform.GetLocation());
+	ProxyRotations.Add(SpawnTransform.Rotator());
+	ProxyStates.Add(Route == INDEX_NONE ? EEnemyState::EES_NoState : EEnemyState::EES_Patrolling);
+	ProxyHealths.Add(EnemyDefaults->Attributes ? EnemyDefaults->Attributes->GetHealth() : 0.0f);
+	ProxyRoutes.Add(Route);
+	ProxyWaypoints.Add(Route == INDEX_NONE ? INDEX_NONE : ChooseNextWaypoint(Routes[Route], INDEX_NONE));
+	ProxyWaitTimes.Add(0.0f);
+	ProxySpeeds.Add(EnemyDefaults->PatrollingSpeed);
+	ProxyWaitRanges.Add(FVector2f(EnemyDefaults->PatrolWaitMin, EnemyDefaults->PatrolWaitMax));
+}
+
+void UEnemyCrowdSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || PromotedEnemies.Contains(Enemy)) return;
+
+	PromotedEnemies.Add(Enemy);
+	PromotedRoutes.Add(INDEX_NONE);
+}
+
+void UEnemyCrowdSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	const int32 Index = PromotedEnemies.Find(Enemy);
+	if (Index == INDEX_NONE) return;
+
+	PromotedEnemies.RemoveAtSwap(Index, 1, false);
+	PromotedRoutes.RemoveAtSwap(Index, 1, false);
+}
+
+bool UEnemyCrowdSubsystem::DemoteEnemy(AEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsDead() || Enemy->EnemyState != EEnemyState::EES_Patrolling) return false;
+
+	const int32 PromotedIndex = PromotedEnemies.Find(Enemy);
+	const int32 PromotedRoute = PromotedIndex != INDEX_NONE ? PromotedRoutes[PromotedIndex] : INDEX_NONE;
+	const int32 Route = PromotedRoute != INDEX_NONE ? PromotedRoute : FindOrAddRoute(Enemy->PatrolTargets);
+
+	int32 Waypoint = INDEX_NONE;
+	if (Route != INDEX_NONE)
+	{
+		Waypoint = Routes[Route].Waypoints.IndexOfByKey(Enemy->PatrolTarget);
+		if (Waypoint == INDEX_NONE)
+		{
+			Waypoint = ChooseNextWaypoint(Routes[Route], INDEX_NONE);
+		}
+	}
+
+	FTimerManager& TimerManager = Enemy->GetWorldTimerManager();
+	const float WaitTime = TimerManager.IsTimerActive(Enemy->PatrolTimer) ? TimerManager.GetTimerRemaining(Enemy->PatrolTimer) : 0.0f;
+
+	ProxyClasses.Add(Enemy->GetClass());
+	ProxyLocations.Add(Enemy->GetActorLocation());
+	ProxyRotations.Add(Enemy->GetActorRotation());
+	ProxyStates.Add(Enemy->EnemyState);
+	ProxyHealths.Add(Enemy->Attributes ? Enemy->Attributes->GetHealth() : 0.0f);
+	ProxyRoutes.Add(Route);
+	ProxyWaypoints.Add(Waypoint);
+	ProxyWaitTimes.Add(WaitTime);
+	ProxySpeeds.Add(Enemy->PatrollingSpeed);
+	ProxyWaitRanges.Add(FVector2f(Enemy->PatrolWaitMin, Enemy->PatrolWaitMax));
+
+	if (PromotedIndex != INDEX_NONE)
+	{
+		PromotedEnemies.RemoveAtSwap(PromotedIndex, 1, false);
+		PromotedRoutes.RemoveAtSwap(PromotedIndex, 1, false);
+	}
+
+	if (UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>())
+	{
+		EnemyPool->ReleaseEnemy(Enemy);
+	}
+	else
+	{
+		Enemy->Destroy();
+	}
+
+	INC_DWORD_STAT(STAT_CrowdDemotions);
+	return true;
+}
+
+bool UEnemyCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyCrowdSubsystem::SimulateProxies(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CrowdSimulation);
+
+	// Straight line patrol between the route's targets, close enough for enemies nobody sees.
+	// Paths are only followed again once a proxy is promoted.
+	const int32 NumProxies = ProxyLocations.Num();
+	for (int32 Index = 0; Index < NumProxies; Index++)
+	{
+		if (ProxyWaitTimes[Index] > 0.0f)
+		{
+			ProxyWaitTimes[Index] -= DeltaTime;
+			continue;
+		}
+
+		const int32 Route = ProxyRoutes[Index];
+		if (Route == INDEX_NONE || !Routes[Route].Locations.IsValidIndex(ProxyWaypoints[Index])) continue;
+
+		FVector& Location = ProxyLocations[Index];
+		const FVector Destination = Routes[Route].Locations[ProxyWaypoints[Index]];
+		const FVector ToDestination(Destination.X - Location.X, Destination.Y - Location.Y, 0.0);
+		const double Distance = ToDestination.Size();
+		const double Step = ProxySpeeds[Index] * DeltaTime;
+
+		if (Distance <= Step)
+		{
+			// Same as `AEnemy::OnPatrolTargetReached()`: pick the next target, then wait.
+			Location.X = Destination.X;
+			Location.Y = Destination.Y;
+			ProxyWaitTimes[Index] = FMath::FRandRange(ProxyWaitRanges[Index].X, ProxyWaitRanges[Index].Y);
+			ProxyWaypoints[Index] = ChooseNextWaypoint(Routes[Route], ProxyWaypoints[Index]);
+		}
+		else
+		{
+			Location += ToDestination * (Step / Distance);
+			ProxyRotations[Index] = ToDestination.Rotation();
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::PromoteProxies()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CrowdPromotion);
+
+	if (PlayerLocations.Num() == 0) return;
+
+	const double PromoteDistanceSquared = FMath::Square(CVarCrowdPromoteDistance.GetValueOnGameThread());
+	int32 PromotionsLeft = CVarCrowdMaxPromotionsPerUpdate.GetValueOnGameThread();
+
+	for (int32 Index = ProxyLocations.Num() - 1; Index >= 0 && PromotionsLeft > 0; Index--)
+	{
+		if (GetMinPlayerDistanceSquared(ProxyLocations[Index]) <= PromoteDistanceSquared)
+		{
+			PromoteProxy(Index);
+			PromotionsLeft--;
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::DemoteEnemies()
+{
+	const double DemoteDistanceSquared = FMath::Square(CVarCrowdDemoteDistance.GetValueOnGameThread());
+
+	for (int32 Index = PromotedEnemies.Num() - 1; Index >= 0; Index--)
+	{
+		AEnemy* Enemy = PromotedEnemies[Index];
+
+		// Dead enemies leave the crowd & go through the regular death & pooling.
+		if (!IsValid(Enemy) || Enemy->IsDead())
+		{
+			PromotedEnemies.RemoveAtSwap(Index, 1, false);
+			PromotedRoutes.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		if (PlayerLocations.Num() > 0 && GetMinPlayerDistanceSquared(Enemy->GetActorLocation()) >= DemoteDistanceSquared)
+		{
+			DemoteEnemy(Enemy);
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::PromoteProxy(int32 Index)
+{
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	const AEnemy* EnemyDefaults = ProxyClasses[Index] ? ProxyClasses[Index]->GetDefaultObject<AEnemy>() : nullptr;
+	if (EnemyPool == nullptr || EnemyDefaults == nullptr)
+	{
+		RemoveProxy(Index);
+		return;
+	}
+
+	// Proxies move in 2D, put the new enemy back on the ground.
+	FVector Location = ProxyLocations[Index];
+	FNavLocation NavLocation;
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys && NavSys->ProjectPointToNavigation(Location, NavLocation, FVector(200.0, 200.0, 1000.0)))
+	{
+		Location = NavLocation.Location + FVector(0.0, 0.0, EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+	}
+
+	AEnemy* Enemy = EnemyPool->AcquireEnemy(ProxyClasses[Index], FTransform(ProxyRotations[Index], Location));
+	if (Enemy == nullptr) return;
+
+	const int32 Route = ProxyRoutes[Index];
+	TArray<AActor*> PatrolTargets;
+	AActor* CurrentPatrolTarget = nullptr;
+	if (Route != INDEX_NONE)
+	{
+		for (int32 Waypoint = 0; Waypoint < Routes[Route].Waypoints.Num(); Waypoint++)
+		{
+			AActor* PatrolTarget = Routes[Route].Waypoints[Waypoint].Get();
+			if (PatrolTarget == nullptr) continue;
+
+			PatrolTargets.Add(PatrolTarget);
+			if (Waypoint == ProxyWaypoints[Index])
+			{
+				CurrentPatrolTarget = PatrolTarget;
+			}
+		}
+	}
+
+	Enemy->RestoreCrowdState(PatrolTargets, CurrentPatrolTarget, ProxyHealths[Index], FMath::Max(ProxyWaitTimes[Index], 0.0f));
+
+	// Already registered by `ResetFromPool()`, keep the proxy's route.
+	RegisterEnemy(Enemy);
+	PromotedRoutes[PromotedEnemies.Find(Enemy)] = Route;
+	RemoveProxy(Index);
+
+	INC_DWORD_STAT(STAT_CrowdPromotions);
+}
+
+void UEnemyCrowdSubsystem::RemoveProxy(int32 Index)
+{
+	ProxyClasses.RemoveAtSwap(Index, 1, false);
+	ProxyLocations.RemoveAtSwap(Index, 1, false);
+	ProxyRotations.RemoveAtSwap(Index, 1, false);
+	ProxyStates.RemoveAtSwap(Index, 1, false);
+	ProxyHealths.RemoveAtSwap(Index, 1, false);
+	ProxyRoutes.RemoveAtSwap(Index, 1, false);
+	ProxyWaypoints.RemoveAtSwap(Index, 1, false);
+	ProxyWaitTimes.RemoveAtSwap(Index, 1, false);
+	ProxySpeeds.RemoveAtSwap(Index, 1, false);
+	ProxyWaitRanges.RemoveAtSwap(Index, 1, false);
+}
+
+int32 UEnemyCrowdSubsystem::FindOrAddRoute(const TArray<AActor*>& PatrolTargets)
+{
+	if (PatrolTargets.Num() == 0) return INDEX_NONE;
+
+	// Enemies of the same group usually share their patrol targets, so do their proxies.
+	for (int32 Index = 0; Index < Routes.Num(); Index++)
+	{
+		const TArray<TWeakObjectPtr<AActor>>& Waypoints = Routes[Index].Waypoints;
+		if (Waypoints.Num() != PatrolTargets.Num()) continue;
+
+		bool bSameRoute = true;
+		for (int32 Waypoint = 0; Waypoint < Waypoints.Num() && bSameRoute; Waypoint++)
+		{
+			bSameRoute = Waypoints[Waypoint].Get() == PatrolTargets[Waypoint];
+		}
+		if (bSameRoute) return Index;
+	}
+
+	FCrowdRoute& Route = Routes.AddDefaulted_GetRef();
+	for (AActor* PatrolTarget : PatrolTargets)
+	{
+		Route.Waypoints.Add(PatrolTarget);
+		Route.Locations.Add(PatrolTarget ? PatrolTarget->GetActorLocation() : FVector::ZeroVector);
+	}
+	return Routes.Num() - 1;
+}
+
+int32 UEnemyCrowdSubsystem::ChooseNextWaypoint(const FCrowdRoute& Route, int32 CurrentWaypoint)
+{
+	// Same draw as `AEnemy::ChoosePatrolTarget()`, any target except the current one.
+	const int32 NumWaypoints = Route.Waypoints.Num();
+	const int32 NumCandidates = CurrentWaypoint == INDEX_NONE ? NumWaypoints : NumWaypoints - 1;
+	if (NumCandidates <= 0) return CurrentWaypoint;
+
+	int32 Selection = FMath::RandRange(0, NumCandidates - 1);
+	if (CurrentWaypoint != INDEX_NONE && Selection >= CurrentWaypoint)
+	{
+		Selection++;
+	}
+	return Selection;
+}
+
+double UEnemyCrowdSubsystem::GetMinPlayerDistanceSquared(const FVector& Location) const
+{
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared2D(Location, PlayerLocation));
+	}
+	return MinDistanceSquared;
+}
+
+void UEnemyCrowdSubsystem::GatherPlayerLocations()
+{
+	PlayerLocations.Reset();
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			PlayerLocations.Add(PlayerController->GetPawn()->GetActorLocation());
+		}
+	}
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/LineOfSightScheduler.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Perception"), STAT_EnemyPerception, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Candidates"), STAT_PerceptionCandidates, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Line Of Sight Requests"), STAT_PerceptionLineOfSightRequests, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<float> CVarPerceptionInterval(
+	TEXT("slash.AI.PerceptionInterval"),
+	0.5f,
+	TEXT("Seconds between two enemy vision updates."),
+	ECVF_Default
+);
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime)
+{
+	PerceptionCountdown -= DeltaTime;
+	if (PerceptionCountdown > 0.0f) return;
+
+	PerceptionCountdown = CVarPerceptionInterval.GetValueOnGameThread();
+	UpdatePerception();
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyPerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyPerceptionSubsystem::UpdatePerception()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyPerception);
+	SLASH_PERF_SCOPE(ESPS_EnemyAI);
+
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+
+	// Like `UPawnSensingComponent` with `bOnlySensePlayers`, only player pawns can be seen.
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			SenseTarget(PlayerController->GetPawn());
+		}
+	}
+}
+
+void UEnemyPerceptionSubsystem::SenseTarget(APawn* Target)
+{
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	if (SpatialHash == nullptr) return;
+
+	// Only enemies within the largest sight radius of the target are considered.
+	NearbyActors.Reset();
+	SpatialHash->QueryRadius(SpatialHash->GetCachedLocation(Target), AEnemy::MaxSightRadius, ESpatialCategory::ESC_Enemy, NearbyActors);
+
+	Candidates.Reset();
+	for (AActor* Actor : NearbyActors)
+	{
+		AEnemy* Enemy = Cast<AEnemy>(Actor);
+		if (Enemy && !Enemy->IsDead())
+		{
+			Candidates.Add(Enemy);
+		}
+	}
+
+	const int32 NumCandidates = Candidates.Num();
+	INC_DWORD_STAT_BY(STAT_PerceptionCandidates, NumCandidates);
+	if (NumCandidates == 0) return;
+
+	OffsetsX.SetNumUninitialized(NumCandidates, false);
+	OffsetsY.SetNumUninitialized(NumCandidates, false);
+	OffsetsZ.SetNumUninitialized(NumCandidates, false);
+	ForwardsX.SetNumUninitialized(NumCandidates, false);
+	ForwardsY.SetNumUninitialized(NumCandidates, false);
+	ForwardsZ.SetNumUninitialized(NumCandidates, false);
+	SightRadiiSquared.SetNumUninitialized(NumCandidates, false);
+	CosPeripheralAngles.SetNumUninitialized(NumCandidates, false);
+	DistancesSquared.SetNumUninitialized(NumCandidates, false);
+	InVisionCone.SetNumUninitialized(NumCandidates, false);
+
+	// Pack enemy data into flat arrays.
+	const FVector TargetLocation = SpatialHash->GetCachedLocation(Target);
+	for (int32 Index = 0; Index < NumCandidates; Index++)
+	{
+		const AEnemy* Enemy = Candidates[Index];
+		const FVector Offset = TargetLocation - SpatialHash->GetCachedLocation(Enemy);
+		const FVector Forward = Enemy->GetActorForwardVector();
+
+		OffsetsX[Index] = Offset.X;
+		OffsetsY[Index] = Offset.Y;
+		OffsetsZ[Index] = Offset.Z;
+		ForwardsX[Index] = Forward.X;
+		ForwardsY[Index] = Forward.Y;
+		ForwardsZ[Index] = Forward.Z;
+		SightRadiiSquared[Index] = FMath::Square(Enemy->SightRadius);
+		CosPeripheralAngles[Index] = FMath::Cos(FMath::DegreesToRadians(Enemy->PeripheralVisionAngle));
+	}
+
+	// Branch-free cone test over the packed arrays, simple enough for the compiler to vectorize.
+	// `Dot / |Offset| >= Cos(Angle)` is tested as `Dot * |Dot| >= Cos(Angle) * |Cos(Angle)| * |Offset|^2`
+	// to avoid the square root.
+	for (int32 Index = 0; Index < NumCandidates; Index++)
+	{
+		const float DistanceSquared =
+			OffsetsX[Index] * OffsetsX[Index] +
+			OffsetsY[Index] * OffsetsY[Index] +
+			OffsetsZ[Index] * OffsetsZ[Index];
+		const float Dot =
+			OffsetsX[Index] * ForwardsX[Index] +
+			OffsetsY[Index] * ForwardsY[Index] +
+			OffsetsZ[Index] * ForwardsZ[Index];
+		const float CosAngle = CosPeripheralAngles[Index];
+
+		DistancesSquared[Index] = DistanceSquared;
+
+		const bool bInRange = DistanceSquared <= SightRadiiSquared[Index];
+		const bool bInAngle = Dot * FMath::Abs(Dot) >= CosAngle * FMath::Abs(CosAngle) * DistanceSquared;
+		InVisionCone[Index] = static_cast<uint8>(bInRange & bInAngle);
+	}
+
+	ULineOfSightScheduler* LineOfSightScheduler = GetWorld()->GetSubsystem<ULineOfSightScheduler>();
+	if (LineOfSightScheduler == nullptr) return;
+
+	// Only the enemies which could see the target pay for a line of sight trace,
+	// traces are spread over the next frames by the scheduler.
+	for (int32 Index = 0; Index < NumCandidates; Index++)
+	{
+		if (InVisionCone[Index] == 0) continue;
+
+		LineOfSightScheduler->RequestLineOfSight(Candidates[Index], Target, DistancesSquared[Index]);
+		INC_DWORD_STAT(STAT_PerceptionLineOfSightRequests);
+	}
+}
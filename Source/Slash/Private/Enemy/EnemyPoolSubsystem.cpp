@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Enemies"), STAT_PooledEnemies, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies Reused From Pool"), STAT_EnemiesReused, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies Spawned"), STAT_EnemiesSpawned, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Enemy Spawns"), STAT_EnemySpawns, STATGROUP_SlashSpawns);
+
+static TAutoConsoleVariable<int32> CVarEnemyPool(
+	TEXT("slash.AI.EnemyPool"),
+	1,
+	TEXT("1: Dead enemies are deactivated & kept for reuse (default).\n")
+	TEXT("0: Dead enemies are destroyed once their death life span is over."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarEnemyPoolMaxSize(
+	TEXT("slash.AI.EnemyPool.MaxSize"),
+	64,
+	TEXT("Maximum number of deactivated enemies kept per world, extra ones are destroyed."),
+	ECVF_Default
+);
+
+void UEnemyPoolSubsystem::Deinitialize()
+{
+	PooledEnemies.Empty();
+	SET_DWORD_STAT(STAT_PooledEnemies, 0);
+
+	Super::Deinitialize();
+}
+
+bool UEnemyPoolSubsystem::IsPoolingEnabled()
+{
+	return CVarEnemyPool.GetValueOnGameThread() != 0;
+}
+
+AEnemy* UEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || EnemyClass == nullptr) return nullptr;
+
+	// Most recently released enemies first, their memory is the most likely to still be warm.
+	for (int32 Index = PooledEnemies.Num() - 1; Index >= 0; Index--)
+	{
+		AEnemy* Enemy = PooledEnemies[Index];
+		if (!IsValid(Enemy))
+		{
+			PooledEnemies.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+		if (Enemy->GetClass() != EnemyClass) continue;
+
+		PooledEnemies.RemoveAtSwap(Index, 1, false);
+		SET_DWORD_STAT(STAT_PooledEnemies, PooledEnemies.Num());
+		INC_DWORD_STAT(STAT_EnemiesReused);
+
+		Enemy->ResetFromPool(SpawnTransform);
+		return Enemy;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	SCOPE_CYCLE_COUNTER(STAT_EnemySpawns);
+	SLASH_PERF_SCOPE(ESPS_Spawns);
+	SLASH_PERF_COUNT(ESPS_Spawns, 1);
+
+	INC_DWORD_STAT(STAT_EnemiesSpawned);
+	return World->SpawnActor<AEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+}
+
+void UEnemyPoolSubsystem::ReleaseEnemy(AEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || PooledEnemies.Contains(Enemy)) return;
+
+	if (PooledEnemies.Num() >= CVarEnemyPoolMaxSize.GetValueOnGameThread())
+	{
+		Enemy->Destroy();
+		return;
+	}
+
+	Enemy->DeactivateForPool();
+	PooledEnemies.Add(Enemy);
+	SET_DWORD_STAT(STAT_PooledEnemies, PooledEnemies.Num());
+}
+
+bool UEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyStateMachine.h"
+#include "Enemy/Enemy.h"
+
+void FEnemyStateMachine::AddTransition(FTransition (&Table)[NumStates][NumEvents], EEnemyState State, EEnemyEvent Event, FTransition Transition)
+{
+	Table[static_cast<int32>(State)][static_cast<int32>(Event)] = Transition;
+}
+
+void FEnemyStateMachine::BuildTransitionTable(FTransition (&Table)[NumStates][NumEvents])
+{
+	using E = EEnemyEvent;
+	using S = EEnemyState;
+
+	// Sighting a target starts a chase from idle & patrol states.
+	AddTransition(Table, S::EES_NoState, E::EEE_TargetSeen, &AEnemy::OnTargetSeen);
+	AddTransition(Table, S::EES_Patrolling, E::EEE_TargetSeen, &AEnemy::OnTargetSeen);
+
+	// Patrol loop: reach a waypoint, wait, move to the next one.
+	AddTransition(Table, S::EES_Patrolling, E::EEE_PatrolTargetReached, &AEnemy::OnPatrolTargetReached);
+	AddTransition(Table, S::EES_Patrolling, E::EEE_PatrolTimerExpired, &AEnemy::ResumePatrol);
+
+	// Combat target got close enough to attack, if an attack token is free.
+	AddTransition(Table, S::EES_NoState, E::EEE_EnteredAttackRadius, &AEnemy::RequestAttack);
+	AddTransition(Table, S::EES_Chasing, E::EEE_EnteredAttackRadius, &AEnemy::RequestAttack);
+
+	// Orbiting enemies wait for their turn, whichever band the target is in.
+	AddTransition(Table, S::EES_Orbiting, E::EEE_AttackTokenGranted, &AEnemy::AttackFromOrbit);
+
+	// Combat target moved out of reach but is still worth chasing.
+	AddTransition(Table, S::EES_NoState, E::EEE_LeftAttackRadius, &AEnemy::ChaseTarget);
+	AddTransition(Table, S::EES_Attacking, E::EEE_LeftAttackRadius, &AEnemy::ChaseFromAttack);
+	AddTransition(Table, S::EES_Engaged, E::EEE_LeftAttackRadius, &AEnemy::ClearAttackTimer);
+
+	// Combat target is gone, either too far away or dead.
+	for (const E Event : { E::EEE_LeftCombatRadius, E::EEE_TargetDied })
+	{
+		AddTransition(Table, S::EES_NoState, Event, &AEnemy::GiveUpCombat);
+		AddTransition(Table, S::EES_Chasing, Event, &AEnemy::GiveUpCombat);
+		AddTransition(Table, S::EES_Attacking, Event, &AEnemy::GiveUpCombat);
+		AddTransition(Table, S::EES_Engaged, Event, &AEnemy::LoseInterestWhileEngaged);
+		AddTransition(Table, S::EES_Orbiting, Event, &AEnemy::GiveUpCombat);
+	}
+
+	// Attack loop: wait for the attack timer, swing, re-evaluate once the montage ends.
+	AddTransition(Table, S::EES_Attacking, E::EEE_AttackTimerExpired, &AEnemy::Attack);
+	AddTransition(Table, S::EES_NoState, E::EEE_AttackEnded, &AEnemy::FinishAttack);
+	AddTransition(Table, S::EES_Chasing, E::EEE_AttackEnded, &AEnemy::FinishAttack);
+	AddTransition(Table, S::EES_Attacking, E::EEE_AttackEnded, &AEnemy::FinishAttack);
+	AddTransition(Table, S::EES_Engaged, E::EEE_AttackEnded, &AEnemy::FinishAttack);
+
+	// Taking damage makes every living enemy turn against the instigator.
+	AddTransition(Table, S::EES_NoState, E::EEE_Damaged, &AEnemy::OnDamaged);
+	AddTransition(Table, S::EES_Patrolling, E::EEE_Damaged, &AEnemy::OnDamaged);
+	AddTransition(Table, S::EES_Chasing, E::EEE_Damaged, &AEnemy::OnDamaged);
+	AddTransition(Table, S::EES_Attacking, E::EEE_Damaged, &AEnemy::OnDamaged);
+	AddTransition(Table, S::EES_Engaged, E::EEE_Damaged, &AEnemy::OnDamaged);
+	AddTransition(Table, S::EES_Orbiting, E::EEE_Damaged, &AEnemy::OnDamaged);
+}
+
+FEnemyStateMachine::FTransition FEnemyStateMachine::GetTransition(EEnemyState State, EEnemyEvent Event)
+{
+	static FTransition Table[NumStates][NumEvents] = {};
+	static bool bTableBuilt = false;
+	if (!bTableBuilt)
+	{
+		BuildTransitionTable(Table);
+		bTableBuilt = true;
+	}
+
+	const int32 StateIndex = static_cast<int32>(State);
+	const int32 EventIndex = static_cast<int32>(Event);
+	if (StateIndex >= NumStates || EventIndex >= NumEvents) return nullptr;
+
+	return Table[StateIndex][EventIndex];
+}
+
+bool FEnemyStateMachine::HasTransition(EEnemyState State, EEnemyEvent Event)
+{
+	return GetTransition(State, Event) != nullptr;
+}
+
+EEnemyEvent FEnemyStateMachine::GetRangeBandEvent(EEnemyRangeBand Band)
+{
+	switch (Band)
+	{
+	case EEnemyRangeBand::ERB_InsideAttackRadius:
+		return EEnemyEvent::EEE_EnteredAttackRadius;
+	case EEnemyRangeBand::ERB_InsideCombatRadius:
+		return EEnemyEvent::EEE_LeftAttackRadius;
+	default:
+		return EEnemyEvent::EEE_LeftCombatRadius;
+	}
+}
+
+bool FEnemyStateMachine::IsRangeWatchedState(EEnemyState State)
+{
+	return State == EEnemyState::EES_NoState || State > EEnemyState::EES_Patrolling;
+}
+
+bool FEnemyStateMachine::CanHoldAttackToken(EEnemyState State)
+{
+	return State == EEnemyState::EES_Chasing || State == EEnemyState::EES_Attacking || State == EEnemyState::EES_Engaged;
+}
@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/LineOfSightScheduler.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Line Of Sight Scheduler"), STAT_LineOfSightScheduler, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Traces Issued"), STAT_LineOfSightTracesIssued, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Line Of Sight Requests Queued"), STAT_LineOfSightRequestsQueued, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<int32> CVarMaxLineOfSightTracesPerFrame(
+	TEXT("slash.AI.LineOfSight.MaxTracesPerFrame"),
+	16,
+	TEXT("Maximum number of enemy line of sight traces issued per frame, the rest wait for later frames."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarLineOfSightMaxWaitFrames(
+	TEXT("slash.AI.LineOfSight.MaxWaitFrames"),
+	30,
+	TEXT("Frames after which a queued line of sight request goes ahead of any new one, however far away its enemy is."),
+	ECVF_Default
+);
+
+// Priority of enemies in combat is scaled up, so they wait behind patrolling enemies at the same distance.
+static constexpr double CombatPriorityScale = 4.0;
+static constexpr double MaxLineOfSightPriority = CombatPriorityScale * AEnemy::MaxSightRadius * AEnemy::MaxSightRadius;
+
+void ULineOfSightScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LineOfSightScheduler);
+	SET_DWORD_STAT(STAT_LineOfSightRequestsQueued, QueuedRequests.Num());
+
+	IssueTraces();
+}
+
+TStatId ULineOfSightScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULineOfSightScheduler, STATGROUP_Tickables);
+}
+
+void ULineOfSightScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &ULineOfSightScheduler::OnTraceCompleted);
+}
+
+void ULineOfSightScheduler::Deinitialize()
+{
+	TraceDelegate.Unbind();
+	QueuedRequests.Empty();
+	InFlightRequests.Empty();
+	PendingEnemies.Empty();
+
+	Super::Deinitialize();
+}
+
+void ULineOfSightScheduler::RequestLineOfSight(AEnemy* Enemy, APawn* Target, double DistanceSquared)
+{
+	if (Enemy == nullptr || Target == nullptr) return;
+
+	const double Priority = ComputePriority(Enemy, DistanceSquared);
+
+	if (PendingEnemies.Contains(Enemy))
+	{
+		// Refresh a queued request, a request already in flight will answer soon enough.
+		for (FLineOfSightRequest& Request : QueuedRequests)
+		{
+			if (Request.Enemy == Enemy)
+			{
+				Request.Target = Target;
+				Request.Priority = FMath::Min(Request.Priority, Priority);
+				break;
+			}
+		}
+		return;
+	}
+
+	FLineOfSightRequest& Request = QueuedRequests.AddDefaulted_GetRef();
+	Request.Enemy = Enemy;
+	Request.Target = Target;
+	Request.Priority = Priority;
+	Request.QueuedFrame = GFrameCounter;
+
+	PendingEnemies.Add(Enemy);
+}
+
+bool ULineOfSightScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void ULineOfSightScheduler::IssueTraces()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || QueuedRequests.Num() == 0) return;
+
+	// Age requests by the frames they've waited, so far away enemies are not starved forever: the
+	// lowest priority catches up with a new request at distance zero after `MaxWaitFrames`.
+	const double AgingPerFrame = MaxLineOfSightPriority / FMath::Max(CVarLineOfSightMaxWaitFrames.GetValueOnGameThread(), 1);
+	const uint64 Frame = GFrameCounter;
+	QueuedRequests.Sort([AgingPerFrame, Frame](const FLineOfSightRequest& A, const FLineOfSightRequest& B)
+	{
+		return A.Priority - AgingPerFrame * (Frame - A.QueuedFrame) < B.Priority - AgingPerFrame * (Frame - B.QueuedFrame);
+	});
+
+	const int32 MaxTraces = FMath::Max(CVarMaxLineOfSightTracesPerFrame.GetValueOnGameThread(), 1);
+	int32 NumProcessed = 0;
+	int32 NumIssued = 0;
+
+	for (; NumProcessed < QueuedRequests.Num() && NumIssued < MaxTraces; NumProcessed++)
+	{
+		FLineOfSightRequest& Request = QueuedRequests[NumProcessed];
+		AEnemy* Enemy = Request.Enemy.Get();
+		APawn* Target = Request.Target.Get();
+
+		if (Enemy == nullptr || Target == nullptr || Enemy->IsDead())
+		{
+			PendingEnemies.Remove(Request.Enemy);
+			continue;
+		}
+
+		FVector EyeLocation;
+		FRotator EyeRotation;
+		Enemy->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(EnemyLineOfSight), true, Enemy);
+		QueryParams.AddIgnoredActor(Target);
+
+		const uint32 RequestId = NextRequestId++;
+		InFlightRequests.Add(RequestId, Request);
+
+		World->AsyncLineTraceByChannel(
+			EAsyncTraceType::Single,
+			EyeLocation,
+			Target->GetActorLocation(),
+			ECollisionChannel::ECC_Visibility,
+			QueryParams,
+			FCollisionResponseParams::DefaultResponseParam,
+			&TraceDelegate,
+			RequestId
+		);
+		NumIssued++;
+	}
+
+	QueuedRequests.RemoveAt(0, NumProcessed, false);
+
+	INC_DWORD_STAT_BY(STAT_LineOfSightTracesIssued, NumIssued);
+}
+
+void ULineOfSightScheduler::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FLineOfSightRequest Request;
+	if (!InFlightRequests.RemoveAndCopyValue(TraceDatum.UserData, Request)) return;
+
+	PendingEnemies.Remove(Request.Enemy);
+
+	AEnemy* Enemy = Request.Enemy.Get();
+	APawn* Target = Request.Target.Get();
+	if (Enemy == nullptr || Target == nullptr) return;
+
+	const bool bBlocked = TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (!bBlocked)
+	{
+		Enemy->PawnSeen(Target);
+	}
+}
+
+double ULineOfSightScheduler::ComputePriority(const AEnemy* Enemy, double DistanceSquared)
+{
+	// Patrolling enemies are the ones a sighting changes the most, so they go first.
+	// Enemies already in combat only refresh what they know & can wait.
+	const bool bCanStartChasing = Enemy->EnemyState <= EEnemyState::EES_Patrolling;
+	return bCanStartChasing ? DistanceSquared : DistanceSquared * CombatPriorityScale;
+}
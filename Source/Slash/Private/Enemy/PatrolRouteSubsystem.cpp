@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/PatrolRouteSubsystem.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Patrol Path Computation"), STAT_PatrolPathComputation, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Patrol Path Cache Hits"), STAT_PatrolPathCacheHits, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Patrol Path Cache Misses"), STAT_PatrolPathCacheMisses, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Patrol Paths Cached"), STAT_PatrolPathsCached, STATGROUP_SlashAI);
+
+void UPatrolRouteSubsystem::Deinitialize()
+{
+	CachedPaths.Empty();
+	SET_DWORD_STAT(STAT_PatrolPathsCached, 0);
+
+	Super::Deinitialize();
+}
+
+void UPatrolRouteSubsystem::RegisterRoute(const TArray<AActor*>& Waypoints, const FNavAgentProperties& AgentProperties)
+{
+	for (const AActor* From : Waypoints)
+	{
+		for (const AActor* To : Waypoints)
+		{
+			if (From && To && From != To)
+			{
+				FindPath(From, To, AgentProperties);
+			}
+		}
+	}
+}
+
+FNavPathSharedPtr UPatrolRouteSubsystem::FindPath(const AActor* From, const AActor* To, const FNavAgentProperties& AgentProperties)
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys == nullptr || From == nullptr || To == nullptr) return nullptr;
+
+	FPatrolPathKey Key;
+	Key.From = From;
+	Key.To = To;
+	Key.NavData = NavSys->GetNavDataForProps(AgentProperties);
+	if (Key.NavData == nullptr) return nullptr;
+
+	const FNavPathSharedPtr* CachedPath = CachedPaths.Find(Key);
+	if (CachedPath && CachedPath->IsValid() && (*CachedPath)->IsValid() && (*CachedPath)->IsUpToDate())
+	{
+		INC_DWORD_STAT(STAT_PatrolPathCacheHits);
+		return *CachedPath;
+	}
+
+	INC_DWORD_STAT(STAT_PatrolPathCacheMisses);
+	return ComputePath(Key, AgentProperties);
+}
+
+bool UPatrolRouteSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FNavPathSharedPtr UPatrolRouteSubsystem::ComputePath(const FPatrolPathKey& Key, const FNavAgentProperties& AgentProperties)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PatrolPathComputation);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	ANavigationData* NavData = Key.NavData;
+
+	const FPathFindingQuery Query(this, *NavData, Key.From->GetActorLocation(), Key.To->GetActorLocation());
+	const FPathFindingResult Result = NavSys->FindPathSync(AgentProperties, Query);
+
+	if (!Result.IsSuccessful() || !Result.Path.IsValid())
+	{
+		// Maybe the navmesh isn't built yet, try again on the next use.
+		CachedPaths.Remove(Key);
+		SET_DWORD_STAT(STAT_PatrolPathsCached, CachedPaths.Num());
+		return nullptr;
+	}
+
+	// The navmesh is rebuilt at runtime: when a tile the path crosses changes, the navigation
+	// data repaths it in place, so enemies following it keep walking instead of being aborted.
+	Result.Path->EnableRecalculationOnInvalidation(true);
+	NavData->RegisterActivePath(Result.Path);
+
+	CachedPaths.Add(Key, Result.Path);
+	SET_DWORD_STAT(STAT_PatrolPathsCached, CachedPaths.Num());
+
+	return Result.Path;
+}
@@ -0,0 +1,419 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/PursuitFlowFieldSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationSystem.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pursuit Flow Field Build"), STAT_PursuitFlowFieldBuild, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Pursuit Steering"), STAT_PursuitSteering, STATGROUP_SlashAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pursuit Chasers"), STAT_PursuitChasers, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pursuit Flow Field Builds"), STAT_PursuitFlowFieldBuilds, STATGROUP_SlashAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pursuit Walkability Queries"), STAT_PursuitWalkabilityQueries, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<int32> CVarFlowFieldPursuit(
+	TEXT("slash.AI.FlowFieldPursuit"),
+	1,
+	TEXT("1: Chasing enemies follow one shared flow field per target (default).\n")
+	TEXT("0: Every chasing enemy paths to its target with its own MoveTo request."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarFlowFieldCellSize(
+	TEXT("slash.AI.FlowField.CellSize"),
+	200.0f,
+	TEXT("Size of a flow field cell, applied on the next world begin play."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarFlowFieldHalfExtent(
+	TEXT("slash.AI.FlowField.HalfExtent"),
+	24,
+	TEXT("Number of cells between the target & the border of its flow field, applied on the next world begin play."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarFlowFieldRebuildInterval(
+	TEXT("slash.AI.FlowField.RebuildInterval"),
+	0.25f,
+	TEXT("Minimum seconds between two rebuilds of the flow field of a moving target."),
+	ECVF_Default
+);
+
+void UPursuitFlowFieldSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_PursuitChasers, Chasers.Num());
+
+	UpdateFlowFields(DeltaTime);
+	SteerChasers();
+}
+
+TStatId UPursuitFlowFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPursuitFlowFieldSubsystem, STATGROUP_Tickables);
+}
+
+void UPursuitFlowFieldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	CellSize = FMath::Max(CVarFlowFieldCellSize.GetValueOnGameThread(), 50.0f);
+	GridHalfExtent = FMath::Clamp(CVarFlowFieldHalfExtent.GetValueOnGameThread(), 1, 127);
+
+	// Walkability is cached, forget it whenever the navmesh is rebuilt.
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.AddDynamic(this, &UPursuitFlowFieldSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+void UPursuitFlowFieldSubsystem::Deinitialize()
+{
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPursuitFlowFieldSubsystem::OnNavigationGenerationFinished);
+	}
+
+	FlowFields.Empty();
+	Chasers.Empty();
+	WalkableCells.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UPursuitFlowFieldSubsystem::IsFlowFieldPursuitEnabled()
+{
+	return CVarFlowFieldPursuit.GetValueOnGameThread() != 0;
+}
+
+void UPursuitFlowFieldSubsystem::StartPursuit(AEnemy* Enemy, AActor* Target)
+{
+	if (Enemy == nullptr || Target == nullptr) return;
+
+	FChaser* Chaser = Chasers.FindByPredicate([Enemy](const FChaser& Other) { return Other.Enemy == Enemy; });
+	if (Chaser && Chaser->Target == Target) return;
+
+	if (Chaser)
+	{
+		if (FFlowField* OldField = FindFlowField(Chaser->Target.Get()))
+		{
+			OldField->NumChasers--;
+		}
+	}
+	else
+	{
+		Chaser = &Chasers.AddDefaulted_GetRef();
+		Chaser->Enemy = Enemy;
+	}
+
+	Chaser->Target = Target;
+	Chaser->bPathFollowing = false;
+
+	FFlowField* Field = FindFlowField(Target);
+	if (Field == nullptr)
+	{
+		Field = &FlowFields.AddDefaulted_GetRef();
+		Field->Target = Target;
+	}
+	Field->NumChasers++;
+
+	// Movement now comes from the flow field, drop any move request still running.
+	if (AController* Controller = Enemy->GetController())
+	{
+		Controller->StopMovement();
+	}
+}
+
+void UPursuitFlowFieldSubsystem::StopPursuit(AEnemy* Enemy)
+{
+	const int32 ChaserIndex = Chasers.IndexOfByPredicate([Enemy](const FChaser& Other) { return Other.Enemy == Enemy; });
+	if (ChaserIndex == INDEX_NONE) return;
+
+	if (FFlowField* Field = FindFlowField(Chasers[ChaserIndex].Target.Get()))
+	{
+		Field->NumChasers--;
+	}
+	Chasers.RemoveAtSwap(ChaserIndex, 1, false);
+}
+
+bool UPursuitFlowFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPursuitFlowFieldSubsystem::UpdateFlowFields(float DeltaTime)
+{
+	for (int32 Index = FlowFields.Num() - 1; Index >= 0; Index--)
+	{
+		FFlowField& Field = FlowFields[Index];
+		const AActor* Target = Field.Target.Get();
+		if (Target == nullptr || Field.NumChasers <= 0)
+		{
+			FlowFields.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		if (GetCell(Target->GetActorLocation()) != Field.TargetCell)
+		{
+			Field.bDirty = true;
+		}
+
+		Field.RebuildCountdown -= DeltaTime;
+		if (Field.bDirty && Field.RebuildCountdown <= 0.0f)
+		{
+			BuildFlowField(Field);
+			Field.RebuildCountdown = CVarFlowFieldRebuildInterval.GetValueOnGameThread();
+		}
+	}
+}
+
+void UPursuitFlowFieldSubsystem::BuildFlowField(FFlowField& Field)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PursuitFlowFieldBuild);
+	INC_DWORD_STAT(STAT_PursuitFlowFieldBuilds);
+
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const FVector TargetLocation = Field.Target->GetActorLocation();
+	const int32 GridSize = GridHalfExtent * 2 + 1;
+
+	Field.TargetCell = GetCell(TargetLocation);
+	Field.Origin = Field.TargetCell - FIntPoint(GridHalfExtent, GridHalfExtent);
+	Field.Costs.Init(MAX_uint16, GridSize * GridSize);
+	Field.bDirty = false;
+
+	// Breadth first search from the target over the walkable cells, 4-connected.
+	OpenCells.Reset();
+	const int32 TargetIndex = GetFieldIndex(Field, Field.TargetCell);
+	Field.Costs[TargetIndex] = 0;
+	OpenCells.Add(TargetIndex);
+
+	static const FIntPoint Neighbours[] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+	for (int32 Head = 0; Head < OpenCells.Num(); Head++)
+	{
+		const int32 CellIndex = OpenCells[Head];
+		const FIntPoint Cell = Field.Origin + FIntPoint(CellIndex % GridSize, CellIndex / GridSize);
+		const uint16 NextCost = Field.Costs[CellIndex] + 1;
+
+		for (const FIntPoint& Offset : Neighbours)
+		{
+			const FIntPoint Neighbour = Cell + Offset;
+			const int32 NeighbourIndex = GetFieldIndex(Field, Neighbour);
+			if (NeighbourIndex == INDEX_NONE || Field.Costs[NeighbourIndex] != MAX_uint16) continue;
+			if (!IsCellWalkable(NavSys, Neighbour, TargetLocation.Z)) continue;
+
+			Field.Costs[NeighbourIndex] = NextCost;
+			OpenCells.Add(NeighbourIndex);
+		}
+	}
+}
+
+void UPursuitFlowFieldSubsystem::SteerChasers()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PursuitSteering);
+
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	if (SpatialHash == nullptr) return;
+
+	// Close to the target, steer straight at it instead of following cell centers.
+	const double DirectSteerDistanceSquared = FMath::Square(CellSize * 2.0);
+
+	for (int32 Index = Chasers.Num() - 1; Index >= 0; Index--)
+	{
+		FChaser& Chaser = Chasers[Index];
+		AEnemy* Enemy = Chaser.Enemy.Get();
+		AActor* Target = Chaser.Target.Get();
+		if (Enemy == nullptr || Target == nullptr)
+		{
+			if (FFlowField* Field = FindFlowField(Target))
+			{
+				Field->NumChasers--;
+			}
+			Chasers.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const FFlowField* Field = FindFlowField(Target);
+		const FVector Location = SpatialHash->GetCachedLocation(Enemy);
+		const FVector TargetLocation = SpatialHash->GetCachedLocation(Target);
+		const double DistanceSquared = FVector::DistSquared2D(Location, TargetLocation);
+
+		// Enemies waiting for an attack token circle the target instead of closing in.
+		if (Enemy->IsOrbiting())
+		{
+			if (Chaser.bPathFollowing)
+			{
+				Chaser.bPathFollowing = false;
+				if (AController* Controller = Enemy->GetController())
+				{
+					Controller->StopMovement();
+				}
+			}
+
+			Enemy->AddMovementInput(ComputeOrbitDirection(Enemy, Location, TargetLocation));
+			continue;
+		}
+
+		// Stop where `MoveTo()` a goal actor stops: capsules can't get closer than both radii.
+		const double StopDistance = Enemy->AcceptanceRadius + Enemy->GetSimpleCollisionRadius() + Target->GetSimpleCollisionRadius();
+		if (DistanceSquared <= FMath::Square(StopDistance)) continue;
+
+		FVector Direction;
+		bool bHasDirection = false;
+		if (DistanceSquared <= DirectSteerDistanceSquared)
+		{
+			Direction = (TargetLocation - Location).GetSafeNormal2D();
+			bHasDirection = true;
+		}
+		else if (Field)
+		{
+			bHasDirection = SampleFlowField(*Field, Location, Direction);
+		}
+
+		if (!bHasDirection)
+		{
+			// The field can't lead this enemy, let path following take over until it can.
+			if (!Chaser.bPathFollowing)
+			{
+				Chaser.bPathFollowing = true;
+				Enemy->MoveToTarget(Target);
+			}
+			continue;
+		}
+
+		if (Chaser.bPathFollowing)
+		{
+			Chaser.bPathFollowing = false;
+			if (AController* Controller = Enemy->GetController())
+			{
+				Controller->StopMovement();
+			}
+		}
+
+		Enemy->AddMovementInput(Direction);
+	}
+}
+
+FVector UPursuitFlowFieldSubsystem::ComputeOrbitDirection(AEnemy* Enemy, const FVector& Location, const FVector& TargetLocation)
+{
+	const FVector ToTarget = (TargetLocation - Location).GetSafeNormal2D();
+	if (ToTarget.IsNearlyZero()) return FVector::ZeroVector;
+
+	// Half of the enemies circle clockwise, the other half counter clockwise.
+	const double Side = (GetTypeHash(Enemy) & 1) ? 1.0 : -1.0;
+	const FVector Tangent(-ToTarget.Y * Side, ToTarget.X * Side, 0.0);
+
+	// Pull back toward the orbit radius when too close or too far.
+	const double OrbitRadius = FMath::Max(Enemy->OrbitRadius, 1.0);
+	const double RadialError = FMath::Clamp((FVector::Dist2D(Location, TargetLocation) - OrbitRadius) / OrbitRadius, -1.0, 1.0);
+
+	return (Tangent + ToTarget * RadialError * 2.0).GetSafeNormal2D();
+}
+
+bool UPursuitFlowFieldSubsystem::SampleFlowField(const FFlowField& Field, const FVector& Location, FVector& OutDirection) const
+{
+	const FIntPoint Cell = GetCell(Location);
+	const int32 CellIndex = GetFieldIndex(Field, Cell);
+	if (CellIndex == INDEX_NONE) return false;
+
+	const uint16 Cost = Field.Costs[CellIndex];
+	if (Cost == MAX_uint16) return false;
+
+	auto GetCost = [this, &Field](const FIntPoint& Other)
+	{
+		const int32 OtherIndex = GetFieldIndex(Field, Other);
+		return OtherIndex == INDEX_NONE ? MAX_uint16 : Field.Costs[OtherIndex];
+	};
+
+	// Head for the cheapest of the 8 neighbours, diagonals only when they don't cut a corner.
+	FIntPoint BestCell = Cell;
+	uint16 BestCost = Cost;
+	for (int32 Y = -1; Y <= 1; Y++)
+	{
+		for (int32 X = -1; X <= 1; X++)
+		{
+			if (X == 0 && Y == 0) continue;
+
+			const FIntPoint Neighbour = Cell + FIntPoint(X, Y);
+			const uint16 NeighbourCost = GetCost(Neighbour);
+			if (NeighbourCost >= BestCost) continue;
+
+			const bool bDiagonal = X != 0 && Y != 0;
+			if (bDiagonal && (GetCost(Cell + FIntPoint(X, 0)) == MAX_uint16 || GetCost(Cell + FIntPoint(0, Y)) == MAX_uint16)) continue;
+
+			BestCell = Neighbour;
+			BestCost = NeighbourCost;
+		}
+	}
+
+	if (BestCell == Cell) return false;
+
+	OutDirection = (GetCellCenter(BestCell, Location.Z) - Location).GetSafeNormal2D();
+	return !OutDirection.IsNearlyZero();
+}
+
+bool UPursuitFlowFieldSubsystem::IsCellWalkable(const UNavigationSystemV1* NavSys, const FIntPoint& Cell, double Height)
+{
+	const int32 Band = FMath::FloorToInt32(Height / WalkableBandHeight);
+	const FIntVector Key(Cell.X, Cell.Y, Band);
+	if (const bool* bWalkable = WalkableCells.Find(Key))
+	{
+		return *bWalkable;
+	}
+
+	INC_DWORD_STAT(STAT_PursuitWalkabilityQueries);
+
+	// Cells are only walkable if the navmesh covers their center, so corridors narrower than
+	// a cell may be missed; chasers on such cells fall back to path following.
+	// Queried from the middle of the band, so every height of the band gets the same answer.
+	FNavLocation NavLocation;
+	const FVector QueryExtent(CellSize * 0.25, CellSize * 0.25, WalkableBandHeight);
+	const double BandCenter = (Band + 0.5) * WalkableBandHeight;
+	const bool bWalkable = NavSys && NavSys->ProjectPointToNavigation(GetCellCenter(Cell, BandCenter), NavLocation, QueryExtent);
+
+	WalkableCells.Add(Key, bWalkable);
+	return bWalkable;
+}
+
+FIntPoint UPursuitFlowFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize)
+	);
+}
+
+FVector UPursuitFlowFieldSubsystem::GetCellCenter(const FIntPoint& Cell, double Height) const
+{
+	return FVector((Cell.X + 0.5) * CellSize, (Cell.Y + 0.5) * CellSize, Height);
+}
+
+int32 UPursuitFlowFieldSubsystem::GetFieldIndex(const FFlowField& Field, const FIntPoint& Cell) const
+{
+	const int32 GridSize = GridHalfExtent * 2 + 1;
+	const FIntPoint Local = Cell - Field.Origin;
+	if (Local.X < 0 || Local.Y < 0 || Local.X >= GridSize || Local.Y >= GridSize) return INDEX_NONE;
+
+	return Local.Y * GridSize + Local.X;
+}
+
+UPursuitFlowFieldSubsystem::FFlowField* UPursuitFlowFieldSubsystem::FindFlowField(const AActor* Target)
+{
+	if (Target == nullptr) return nullptr;
+
+	return FlowFields.FindByPredicate([Target](const FFlowField& Field) { return Field.Target.Get() == Target; });
+}
+
+void UPursuitFlowFieldSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	WalkableCells.Reset();
+
+	for (FFlowField& Field : FlowFields)
+	{
+		Field.bDirty = true;
+	}
+}
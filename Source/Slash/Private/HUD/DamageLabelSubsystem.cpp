@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/DamageLabelSubsystem.h"
+#include "Items/Weapons/Weapon.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Label Update"), STAT_DamageLabelUpdate, STATGROUP_SlashHUD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damage Labels Visible"), STAT_DamageLabelsVisible, STATGROUP_SlashHUD);
+
+static TAutoConsoleVariable<float> CVarDamageLabelUpdateInterval(
+	TEXT("slash.HUD.DamageLabelUpdateInterval"),
+	0.2f,
+	TEXT("Seconds between two checks of the player distance to the weapon pickups showing a damage label."),
+	ECVF_Default
+);
+
+void UDamageLabelSubsystem::Tick(float DeltaTime)
+{
+	if (RegisteredWeapons.Num() == 0 && VisibleWeapons.Num() == 0) return;
+
+	UpdateCountdown -= DeltaTime;
+	if (UpdateCountdown > 0.0f) return;
+
+	UpdateCountdown = CVarDamageLabelUpdateInterval.GetValueOnGameThread();
+	UpdateLabels();
+}
+
+TStatId UDamageLabelSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageLabelSubsystem, STATGROUP_Tickables);
+}
+
+void UDamageLabelSubsystem::Deinitialize()
+{
+	RegisteredWeapons.Empty();
+	VisibleWeapons.Empty();
+	SET_DWORD_STAT(STAT_DamageLabelsVisible, 0);
+
+	Super::Deinitialize();
+}
+
+void UDamageLabelSubsystem::RegisterWeapon(AWeapon* Weapon)
+{
+	if (Weapon == nullptr) return;
+
+	RegisteredWeapons.Add(Weapon);
+	MaxRadius = FMath::Max<double>(MaxRadius, Weapon->GetDamageHUDRadius());
+
+	// Check right away, the player may already be next to the new weapon.
+	UpdateCountdown = 0.0f;
+}
+
+void UDamageLabelSubsystem::UnregisterWeapon(AWeapon* Weapon)
+{
+	RegisteredWeapons.Remove(Weapon);
+
+	if (VisibleWeapons.Remove(Weapon) > 0)
+	{
+		Weapon->SetDamageHUDVisible(false);
+		SET_DWORD_STAT(STAT_DamageLabelsVisible, VisibleWeapons.Num());
+	}
+}
+
+bool UDamageLabelSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDamageLabelSubsystem::UpdateLabels()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageLabelUpdate);
+	SLASH_PERF_SCOPE(ESPS_HUD);
+
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	if (SpatialHash == nullptr) return;
+
+	// Weapons within their radius of any player.
+	InRangeWeapons.Reset();
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		const APawn* Player = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (Player == nullptr) continue;
+
+		const FVector PlayerLocation = SpatialHash->GetCachedLocation(Player);
+
+		NearbyActors.Reset();
+		SpatialHash->QueryRadius(PlayerLocation, MaxRadius, ESpatialCategory::ESC_Pickup, NearbyActors);
+
+		for (AActor* Actor : NearbyActors)
+		{
+			AWeapon* Weapon = Cast<AWeapon>(Actor);
+			if (Weapon && RegisteredWeapons.Contains(Weapon) &&
+				FVector::DistSquared(SpatialHash->GetCachedLocation(Weapon), PlayerLocation) <= FMath::Square(Weapon->GetDamageHUDRadius()))
+			{
+				InRangeWeapons.AddUnique(Weapon);
+			}
+		}
+	}
+
+	// Only touch the labels which change.
+	for (int32 Index = VisibleWeapons.Num() - 1; Index >= 0; Index--)
+	{
+		if (!InRangeWeapons.Contains(VisibleWeapons[Index]))
+		{
+			if (AWeapon* Weapon = VisibleWeapons[Index].Get())
+			{
+				Weapon->SetDamageHUDVisible(false);
+			}
+			VisibleWeapons.RemoveAtSwap(Index, 1, false);
+		}
+	}
+	for (const TWeakObjectPtr<AWeapon>& Weapon : InRangeWeapons)
+	{
+		if (!VisibleWeapons.Contains(Weapon))
+		{
+			Weapon->SetDamageHUDVisible(true);
+			VisibleWeapons.Add(Weapon);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_DamageLabelsVisible, VisibleWeapons.Num());
+	SLASH_PERF_COUNT(ESPS_HUD, VisibleWeapons.Num());
+}
@@ -19,6 +19,6 @@ void AHealth::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 
 		SpawnPickupSystem();
 		SpawnPickupSound();
-		Destroy();
+		ReleaseToPool();
 	}
 }
@@ -9,13 +9,16 @@
 #include "NiagaraFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/CapsuleComponent.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Items/PickupHoverSubsystem.h"
+#include "Items/PickupPoolSubsystem.h"
+#include "Slash/SlashCollision.h"
 
 // Sets default values
 AItem::AItem()
 {
-	// Set this actor to call Tick() every frame.
-	// You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Hovering items are moved by `UPickupHoverSubsystem`, items don't need to tick.
+	PrimaryActorTick.bCanEverTick = false;
 
 	ItemMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ItemMeshComponent"));
 	ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
@@ -27,6 +30,7 @@ AItem::AItem()
 
 	Sphere = CreateDefaultSubobject<USphereComponent>(TEXT("Sphere"));
 	Sphere->SetupAttachment(GetRootComponent());
+	Sphere->SetCollisionProfileName(SlashCollisionProfile::Pickup);
 
 	ItemEffect = CreateDefaultSubobject<UNiagaraComponent>(TEXT("Embers"));
 	ItemEffect->SetupAttachment(GetRootComponent());
@@ -39,6 +43,86 @@ void AItem::BeginPlay()
 
 	Sphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
 	Sphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+
+	if (ItemState == EItemState::EIS_Hovering)
+	{
+		RegisterAsPickup();
+		StartHovering();
+	}
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterAsPickup();
+	StopHovering();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItem::DeactivateForPool()
+{
+	UnregisterAsPickup();
+	StopHovering();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	ItemEffect->Deactivate();
+}
+
+void AItem::ResetFromPool(const FTransform& SpawnTransform)
+{
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	ItemState = EItemState::EIS_Hovering;
+
+	ItemEffect->Activate(true);
+	SetActorHiddenInGame(false);
+	RegisterAsPickup();
+	StartHovering();
+
+	// Last, a character already overlapping the sphere collects the item right away.
+	SetActorEnableCollision(true);
+}
+
+void AItem::ReleaseToPool()
+{
+	if (UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>())
+	{
+		PickupPool->ReleasePickup(this);
+		return;
+	}
+	Destroy();
+}
+
+void AItem::RegisterAsPickup()
+{
+	if (USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>())
+	{
+		SpatialHash->RegisterActor(this, ESpatialCategory::ESC_Pickup);
+	}
+}
+
+void AItem::UnregisterAsPickup()
+{
+	if (USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterActor(this);
+	}
+}
+
+void AItem::StartHovering()
+{
+	if (UPickupHoverSubsystem* PickupHover = GetWorld()->GetSubsystem<UPickupHoverSubsystem>())
+	{
+		PickupHover->StartHovering(this);
+	}
+}
+
+void AItem::StopHovering()
+{
+	if (UPickupHoverSubsystem* PickupHover = GetWorld()->GetSubsystem<UPickupHoverSubsystem>())
+	{
+		PickupHover->StopHovering(this);
+	}
 }
 
 float AItem::TransformedSin()
@@ -101,28 +185,3 @@ bool AItem::IsCapsuleComponent(UPrimitiveComponent* Component)
 
 	return (CapsuleComponent == nullptr) ? false : true;
 }
-
-// Called every frame
-void AItem::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-	RunningTime += DeltaTime;
-
-	// Computed rotation using DeltaTime
-	//float RotationValue = 80.0f * DeltaTime;
-
-	// Rotate along Pitch (Y-axis)
-	/*AddActorWorldRotation(
-		FRotator(RotationValue, 0.0f, 0.0f)
-	);*/
-
-	// Show FPS
-	float FpsValue = 1.0f / DeltaTime;
-	GEngine->AddOnScreenDebugMessage(1, 0.5f, FColor::Red, FString::Printf(TEXT("\n\n\n\n\n\n\n\n\n\nFPS: %f"), FpsValue));
-
-	if (ItemState == EItemState::EIS_Hovering)
-	{
-		AddActorWorldOffset(FVector(0.f, 0.f, TransformedSin()));
-	}
-}
-
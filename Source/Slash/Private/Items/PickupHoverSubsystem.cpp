@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/PickupHoverSubsystem.h"
+#include "Items/Item.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pickup Hover"), STAT_PickupHover, STATGROUP_SlashItems);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hovering Pickups"), STAT_HoveringPickups, STATGROUP_SlashItems);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hovering Pickups Moved"), STAT_HoveringPickupsMoved, STATGROUP_SlashItems);
+
+static TAutoConsoleVariable<float> CVarPickupHoverRenderTolerance(
+	TEXT("slash.Items.HoverRenderTolerance"),
+	0.25f,
+	TEXT("Hovering items not rendered within this many seconds aren't moved."),
+	ECVF_Default
+);
+
+// Items used to add their bob offset every frame, the scale keeps the motion they had at 60 FPS.
+static constexpr float HoverReferenceFrameRate = 60.0f;
+
+void UPickupHoverSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_HoveringPickups, Items.Num());
+	if (Items.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_PickupHover);
+	SLASH_PERF_SCOPE(ESPS_Pickups);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const float RenderTolerance = CVarPickupHoverRenderTolerance.GetValueOnGameThread();
+
+	for (int32 Index = Items.Num() - 1; Index >= 0; Index--)
+	{
+		AItem* Item = Items[Index].Get();
+		if (Item == nullptr)
+		{
+			RemoveItemAt(Index);
+			continue;
+		}
+
+		bool bDrifting = false;
+		if (DriftRates[Index] < 0.0f && BaseLocations[Index].Z > DriftFloorZs[Index])
+		{
+			BaseLocations[Index].Z = FMath::Max(BaseLocations[Index].Z + DriftRates[Index] * DeltaTime, DriftFloorZs[Index]);
+			bDrifting = true;
+		}
+
+		// Still exposed to Blueprints through `TransformedSin()` & `TransformedCos()`.
+		const float RunningTime = Now - StartTimes[Index];
+		Item->RunningTime = RunningTime;
+
+		if (!bDrifting && !Item->WasRecentlyRendered(RenderTolerance)) continue;
+
+		const double BobOffset = BobScales[Index] * (1.0 - FMath::Cos(BobRates[Index] * RunningTime));
+		Item->SetActorLocation(BaseLocations[Index] + FVector(0.0, 0.0, BobOffset));
+		INC_DWORD_STAT(STAT_HoveringPickupsMoved);
+		SLASH_PERF_COUNT(ESPS_Pickups, 1);
+	}
+}
+
+TStatId UPickupHoverSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPickupHoverSubsystem, STATGROUP_Tickables);
+}
+
+void UPickupHoverSubsystem::Deinitialize()
+{
+	Items.Empty();
+	BaseLocations.Empty();
+	StartTimes.Empty();
+	BobScales.Empty();
+	BobRates.Empty();
+	DriftRates.Empty();
+	DriftFloorZs.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPickupHoverSubsystem::StartHovering(AItem* Item)
+{
+	if (Item == nullptr || Items.Contains(Item)) return;
+
+	Items.Add(Item);
+	BaseLocations.Add(Item->GetActorLocation());
+	StartTimes.Add(GetWorld()->GetTimeSeconds());
+	BobRates.Add(Item->TimeConstant);
+	BobScales.Add(Item->TimeConstant != 0.0f ? Item->Amplitude * HoverReferenceFrameRate / Item->TimeConstant : 0.0f);
+	DriftRates.Add(0.0f);
+	DriftFloorZs.Add(0.0);
+}
+
+void UPickupHoverSubsystem::StopHovering(AItem* Item)
+{
+	const int32 Index = Items.IndexOfByKey(Item);
+	if (Index != INDEX_NONE)
+	{
+		RemoveItemAt(Index);
+	}
+}
+
+void UPickupHoverSubsystem::SetDrift(AItem* Item, float Rate, double FloorZ)
+{
+	const int32 Index = Items.IndexOfByKey(Item);
+	if (Index == INDEX_NONE) return;
+
+	DriftRates[Index] = FMath::Min(Rate, 0.0f);
+	DriftFloorZs[Index] = FloorZ;
+}
+
+bool UPickupHoverSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPickupHoverSubsystem::RemoveItemAt(int32 Index)
+{
+	Items.RemoveAtSwap(Index, 1, false);
+	BaseLocations.RemoveAtSwap(Index, 1, false);
+	StartTimes.RemoveAtSwap(Index, 1, false);
+	BobScales.RemoveAtSwap(Index, 1, false);
+	BobRates.RemoveAtSwap(Index, 1, false);
+	DriftRates.RemoveAtSwap(Index, 1, false);
+	DriftFloorZs.RemoveAtSwap(Index, 1, false);
+}
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/PickupPoolSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pickup Spawns"), STAT_PickupSpawns, STATGROUP_SlashSpawns);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Pickups"), STAT_PooledPickups, STATGROUP_SlashSpawns);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickups Reused From Pool"), STAT_PickupsReused, STATGROUP_SlashSpawns);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickups Spawned"), STAT_PickupsSpawned, STATGROUP_SlashSpawns);
+
+static TAutoConsoleVariable<int32> CVarPickupPool(
+	TEXT("slash.Items.PickupPool"),
+	1,
+	TEXT("1: Collected pickups are deactivated & kept for reuse (default).\n")
+	TEXT("0: Collected pickups are destroyed."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarPickupPoolMaxPerClass(
+	TEXT("slash.Items.PickupPool.MaxPerClass"),
+	32,
+	TEXT("Maximum number of deactivated pickups kept per class & world, extra ones are destroyed."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarPickupPoolPrewarmCount(
+	TEXT("slash.Items.PickupPool.PrewarmCount"),
+	2,
+	TEXT("Number of pickups spawned ahead of time for every class an enemy or breakable can drop."),
+	ECVF_Default
+);
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	PooledPickups.Empty();
+	SET_DWORD_STAT(STAT_PooledPickups, 0);
+
+	Super::Deinitialize();
+}
+
+AItem* UPickupPoolSubsystem::AcquirePickup(TSubclassOf<AItem> PickupClass, const FTransform& SpawnTransform, AActor* Owner, TFunctionRef<void(AItem*)> Setup)
+{
+	if (GetWorld() == nullptr || PickupClass == nullptr) return nullptr;
+
+	if (FPooledPickups* Pool = PooledPickups.Find(PickupClass))
+	{
+		// Most recently released pickups first, their memory is the most likely to still be warm.
+		while (Pool->Pickups.Num() > 0)
+		{
+			AItem* Pickup = Pool->Pickups.Pop(false);
+			if (!IsValid(Pickup)) continue;
+
+			UpdatePooledStat();
+			INC_DWORD_STAT(STAT_PickupsReused);
+
+			Pickup->SetOwner(Owner);
+			Setup(Pickup);
+			Pickup->ResetFromPool(SpawnTransform);
+			return Pickup;
+		}
+	}
+
+	return SpawnPickup(PickupClass, SpawnTransform, Owner, Setup);
+}
+
+void UPickupPoolSubsystem::ReleasePickup(AItem* Pickup)
+{
+	if (!IsValid(Pickup)) return;
+
+	FPooledPickups& Pool = PooledPickups.FindOrAdd(Pickup->GetClass());
+	if (Pool.Pickups.Contains(Pickup)) return;
+
+	if (CVarPickupPool.GetValueOnGameThread() == 0 || Pool.Pickups.Num() >= CVarPickupPoolMaxPerClass.GetValueOnGameThread())
+	{
+		Pickup->Destroy();
+		return;
+	}
+
+	Pickup->DeactivateForPool();
+	Pool.Pickups.Add(Pickup);
+	UpdatePooledStat();
+}
+
+void UPickupPoolSubsystem::PrewarmPickups(TSubclassOf<AItem> PickupClass)
+{
+	if (PickupClass == nullptr || CVarPickupPool.GetValueOnGameThread() == 0) return;
+
+	const int32 PrewarmCount = FMath::Min(CVarPickupPoolPrewarmCount.GetValueOnGameThread(), CVarPickupPoolMaxPerClass.GetValueOnGameThread());
+	FPooledPickups& Pool = PooledPickups.FindOrAdd(PickupClass);
+
+	for (int32 Count = Pool.Pickups.Num(); Count < PrewarmCount; Count++)
+	{
+		// No collision from the start, nothing may collect a pickup which isn't dropped yet.
+		AItem* Pickup = SpawnPickup(PickupClass, FTransform::Identity, nullptr, [](AItem* Pickup) { Pickup->SetActorEnableCollision(false); });
+		if (Pickup == nullptr) break;
+
+		// Spawning may add to the map, don't keep `Pool` across it.
+		ReleasePickup(Pickup);
+	}
+}
+
+bool UPickupPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AItem* UPickupPoolSubsystem::SpawnPickup(TSubclassOf<AItem> PickupClass, const FTransform& SpawnTransform, AActor* Owner, TFunctionRef<void(AItem*)> Setup)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PickupSpawns);
+	INC_DWORD_STAT(STAT_PickupsSpawned);
+
+	// Deferred, so the value is set before `BeginPlay()` & the first overlaps.
+	AItem* Pickup = GetWorld()->SpawnActorDeferred<AItem>(PickupClass, SpawnTransform, Owner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Pickup == nullptr) return nullptr;
+
+	Setup(Pickup);
+	Pickup->FinishSpawning(SpawnTransform);
+	return Pickup;
+}
+
+void UPickupPoolSubsystem::UpdatePooledStat()
+{
+	int32 NumPooled = 0;
+	for (const TPair<TSubclassOf<AItem>, FPooledPickups>& Pool : PooledPickups)
+	{
+		NumPooled += Pool.Value.Pickups.Num();
+	}
+	SET_DWORD_STAT(STAT_PooledPickups, NumPooled);
+}
@@ -4,24 +4,24 @@
 #include "Items/Soul.h"
 #include "Interfaces/PickupInterface.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Items/PickupHoverSubsystem.h"
 
-void ASoul::Tick(float DeltaTime)
+void ASoul::BeginPlay()
 {
-	Super::Tick(DeltaTime);
-
-	const double LocationZ = GetActorLocation().Z;
+	Super::BeginPlay();
 
-	if (LocationZ > DesiredZ)
-	{
-		const FVector DeltaLocation = FVector(0.0f, 0.0f, DriftRate * DeltaTime);
-		AddActorWorldOffset(DeltaLocation);
-	}
+	StartDrifting();
 }
 
-void ASoul::BeginPlay()
+void ASoul::ResetFromPool(const FTransform& SpawnTransform)
 {
-	Super::BeginPlay();
+	Super::ResetFromPool(SpawnTransform);
 
+	StartDrifting();
+}
+
+void ASoul::StartDrifting()
+{
 	const FVector Start = GetActorLocation();
 	const FVector End = Start - FVector(0.0f, 0.0f, 2000.0f);
 
@@ -46,6 +46,12 @@ void ASoul::BeginPlay()
 	);
 
 	DesiredZ = HitResult.ImpactPoint.Z + 50.0f;
+
+	// Drift down while hovering.
+	if (UPickupHoverSubsystem* PickupHover = GetWorld()->GetSubsystem<UPickupHoverSubsystem>())
+	{
+		PickupHover->SetDrift(this, DriftRate, DesiredZ);
+	}
 }
 
 void ASoul::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -63,6 +69,6 @@ void ASoul::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 
 		SpawnPickupSystem();
 		SpawnPickupSound();
-		Destroy();
+		ReleaseToPool();
 	}
 }
@@ -18,6 +18,6 @@ void ATreasure::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AAc
 		PickupInterface->AddGold(this);
 
 		SpawnPickupSound();
-		Destroy();
+		ReleaseToPool();
 	}
 }
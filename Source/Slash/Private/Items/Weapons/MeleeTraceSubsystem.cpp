@@ -0,0 +1,273 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/Weapons/MeleeTraceSubsystem.h"
+#include "Items/Weapons/Weapon.h"
+#include "Characters/BaseCharacter.h"
+#include "Components/HitboxComponent.h"
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+#include "Slash/SlashCollision.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Sweeps"), STAT_MeleeSweeps, STATGROUP_SlashCombat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Swinging Weapons"), STAT_SwingingWeapons, STATGROUP_SlashCombat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee Sweep Steps"), STAT_MeleeSweepSteps, STATGROUP_SlashCombat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Hitboxes"), STAT_ActiveHitboxes, STATGROUP_SlashCombat);
+
+static TAutoConsoleVariable<int32> CVarAsyncMeleeTraces(
+	TEXT("slash.Combat.AsyncMeleeTraces"),
+	1,
+	TEXT("Run the weapon hit detection sweeps as async scene queries.\n")
+	TEXT("0: Synchronous sweeps at the end of the frame, hits are applied in the same frame.\n")
+	TEXT("1: Async sweeps, hits are applied once the queries complete, about one frame later (default)."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarMeleeSubStepDistance(
+	TEXT("slash.Combat.MeleeSubStepDistance"),
+	25.0f,
+	TEXT("Largest distance the blade moves between two sweeps of a swing, in unreal units.\n")
+	TEXT("Keep it below the thinnest target, fewer sub-steps are needed at high frame rates."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarMeleeMaxSubSteps(
+	TEXT("slash.Combat.MeleeMaxSubSteps"),
+	8,
+	TEXT("Maximum number of sweeps per swinging weapon & frame."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarHitboxActivationRadius(
+	TEXT("slash.Combat.HitboxActivationRadius"),
+	400.0f,
+	TEXT("Hitboxes of the characters within this distance of a swinging weapon are activated & follow their bones."),
+	ECVF_Default
+);
+
+void UMeleeTraceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	AsyncSweepDelegate.BindUObject(this, &UMeleeTraceSubsystem::OnAsyncSweepCompleted);
+}
+
+void UMeleeTraceSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_SwingingWeapons, Swings.Num());
+	if (Swings.Num() == 0 && ActiveHitboxes.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_MeleeSweeps);
+	SLASH_PERF_SCOPE(ESPS_WeaponTraces);
+
+	UpdateHitboxes();
+	if (Swings.Num() == 0) return;
+
+	const bool bAsync = CVarAsyncMeleeTraces.GetValueOnGameThread() != 0;
+
+	// Applying a hit may begin or end swings, go through the weapons swinging now.
+	TArray<TWeakObjectPtr<AWeapon>, TInlineAllocator<16>> Weapons;
+	for (const FSwing& Swing : Swings)
+	{
+		Weapons.Add(Swing.Weapon);
+	}
+
+	for (const TWeakObjectPtr<AWeapon>& Weapon : Weapons)
+	{
+		FSwing* Swing = Swings.FindByPredicate([&Weapon](const FSwing& Other) { return Other.Weapon == Weapon; });
+		if (Swing)
+		{
+			SweepSwing(*Swing, bAsync);
+		}
+	}
+
+	Swings.RemoveAllSwap([](const FSwing& Swing) { return !Swing.Weapon.IsValid(); });
+}
+
+TStatId UMeleeTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeTraceSubsystem, STATGROUP_Tickables);
+}
+
+void UMeleeTraceSubsystem::Deinitialize()
+{
+	Swings.Empty();
+	ActiveHitboxes.Empty();
+	InFlightSweeps.Empty();
+	AsyncSweepDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+void UMeleeTraceSubsystem::BeginSwing(AWeapon* Weapon)
+{
+	if (Weapon == nullptr || Swings.ContainsByPredicate([Weapon](const FSwing& Swing) { return Swing.Weapon == Weapon; })) return;
+
+	// The first sweep only covers the pose the swing starts at.
+	FSwing& Swing = Swings.AddDefaulted_GetRef();
+	Swing.Weapon = Weapon;
+	Swing.PreviousBladeTransform = Weapon->GetBladeTransform();
+}
+
+void UMeleeTraceSubsystem::EndSwing(AWeapon* Weapon)
+{
+	const int32 Index = Swings.IndexOfByPredicate([Weapon](const FSwing& Swing) { return Swing.Weapon == Weapon; });
+	if (Index == INDEX_NONE) return;
+
+	// Removed before sweeping, a hit may start the next swing of the weapon right away.
+	FSwing Swing = Swings[Index];
+	Swings.RemoveAtSwap(Index, 1, false);
+
+	SweepSwing(Swing, CVarAsyncMeleeTraces.GetValueOnGameThread() != 0);
+}
+
+bool UMeleeTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMeleeTraceSubsystem::UpdateHitboxes()
+{
+	NearbyHitboxes.Reset();
+
+	USpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<USpatialHashSubsystem>();
+	const double Radius = CVarHitboxActivationRadius.GetValueOnGameThread();
+	for (const FSwing& Swing : Swings)
+	{
+		const AWeapon* Weapon = Swing.Weapon.Get();
+		if (Weapon == nullptr || SpatialHash == nullptr) continue;
+
+		NearbyActors.Reset();
+		SpatialHash->QueryRadius(Weapon->GetActorLocation(), Radius, ESpatialCategory::ESC_Pawns, NearbyActors);
+
+		for (AActor* Actor : NearbyActors)
+		{
+			const ABaseCharacter* Character = Cast<ABaseCharacter>(Actor);
+			if (Character == nullptr || Actor == Weapon->GetOwner() || Character->HasCombatFlags(ECombatFlags::ECF_Dead)) continue;
+
+			if (UHitboxComponent* Hitboxes = Character->GetHitboxes())
+			{
+				NearbyHitboxes.AddUnique(Hitboxes);
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UHitboxComponent>& Hitboxes : ActiveHitboxes)
+	{
+		if (Hitboxes.IsValid() && !NearbyHitboxes.Contains(Hitboxes.Get()))
+		{
+			Hitboxes->SetHitboxesActive(false);
+		}
+	}
+
+	// Newly activated hitboxes are moved to their bones right away.
+	ActiveHitboxes.Reset();
+	for (UHitboxComponent* Hitboxes : NearbyHitboxes)
+	{
+		if (Hitboxes->AreHitboxesActive())
+		{
+			Hitboxes->UpdateHitboxes();
+		}
+		else
+		{
+			Hitboxes->SetHitboxesActive(true);
+		}
+		ActiveHitboxes.Add(Hitboxes);
+	}
+
+	SET_DWORD_STAT(STAT_ActiveHitboxes, ActiveHitboxes.Num());
+}
+
+void UMeleeTraceSubsystem::SweepSwing(FSwing& Swing, bool bAsync)
+{
+	AWeapon* Weapon = Swing.Weapon.Get();
+	if (Weapon == nullptr) return;
+
+	UWorld* World = GetWorld();
+	const uint32 SwingId = Weapon->GetSwingId();
+	const FTransform PreviousBladeTransform = Swing.PreviousBladeTransform;
+	const FTransform BladeTransform = Weapon->GetBladeTransform();
+	Swing.PreviousBladeTransform = BladeTransform;
+
+	FVector PreviousStart;
+	FVector PreviousEnd;
+	FVector Start;
+	FVector End;
+	FQuat Rotation;
+	Weapon->GetSweep(PreviousBladeTransform, PreviousStart, PreviousEnd, Rotation);
+	Weapon->GetSweep(BladeTransform, Start, End, Rotation);
+
+	// As many steps as needed so neither end of the blade moves more than the sub-step distance.
+	const double Distance = FMath::Max(FVector::Dist(PreviousStart, Start), FVector::Dist(PreviousEnd, End));
+	const double SubStepDistance = FMath::Max(CVarMeleeSubStepDistance.GetValueOnGameThread(), 1.0f);
+	const int32 MaxSubSteps = FMath::Max(CVarMeleeMaxSubSteps.GetValueOnGameThread(), 1);
+	const int32 NumSteps = FMath::Clamp(FMath::CeilToInt32(Distance / SubStepDistance), 1, MaxSubSteps);
+	INC_DWORD_STAT_BY(STAT_MeleeSweepSteps, NumSteps);
+	SLASH_PERF_COUNT(ESPS_WeaponTraces, NumSteps);
+
+	FCollisionShape Shape;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MeleeSweep), false, Weapon);
+	Weapon->GetSweepQuery(Shape, QueryParams);
+
+	// Blocking objects are reported as touches, so one sweep returns every actor along the blade.
+	const FCollisionResponseParams ResponseParams(ECollisionResponse::ECR_Overlap);
+
+	const uint32 SweepId = bAsync ? NextSweepId++ : 0;
+	if (bAsync)
+	{
+		FInFlightSweep& InFlightSweep = InFlightSweeps.Add(SweepId);
+		InFlightSweep.Weapon = Weapon;
+		InFlightSweep.SwingId = SwingId;
+		InFlightSweep.NumPendingSteps = NumSteps;
+	}
+
+	for (int32 Step = 1; Step <= NumSteps; Step++)
+	{
+		// Blend the transforms rather than the end points, the blade follows the arc of the swing.
+		FTransform StepTransform;
+		StepTransform.Blend(PreviousBladeTransform, BladeTransform, static_cast<float>(Step) / NumSteps);
+		Weapon->GetSweep(StepTransform, Start, End, Rotation);
+
+		if (bAsync)
+		{
+			World->AsyncSweepByChannel(EAsyncTraceType::Multi, Start, End, Rotation, ECC_WeaponTrace, Shape,
+				QueryParams, ResponseParams, &AsyncSweepDelegate, SweepId);
+			continue;
+		}
+
+		// Local, a hit may end a swing & sweep again.
+		TArray<FHitResult> SweepHits;
+		World->SweepMultiByChannel(SweepHits, Start, End, Rotation, ECC_WeaponTrace, Shape, QueryParams, ResponseParams);
+		for (const FHitResult& Hit : SweepHits)
+		{
+			Weapon->OnSweepHit(Hit, SwingId);
+		}
+
+		// Applying a hit may destroy the weapon, e.g. by killing its owner.
+		if (!IsValid(Weapon)) return;
+	}
+}
+
+void UMeleeTraceSubsystem::OnAsyncSweepCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	// All steps of a swept frame share the user data, forget it with the last one.
+	FInFlightSweep* InFlightSweep = InFlightSweeps.Find(TraceDatum.UserData);
+	if (InFlightSweep == nullptr) return;
+
+	AWeapon* Weapon = InFlightSweep->Weapon.Get();
+	const uint32 SwingId = InFlightSweep->SwingId;
+	if (--InFlightSweep->NumPendingSteps <= 0)
+	{
+		InFlightSweeps.Remove(TraceDatum.UserData);
+	}
+
+	if (Weapon == nullptr) return;
+
+	for (const FHitResult& Hit : TraceDatum.OutHits)
+	{
+		Weapon->OnSweepHit(Hit, SwingId);
+		if (!IsValid(Weapon)) return;
+	}
+}
@@ -6,20 +6,22 @@
 #include "Kismet/GameplayStatics.h"
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Interfaces/HitInterface.h"
 #include "NiagaraComponent.h"
 #include "HUD/WeaponDamageComponent.h"
+#include "Items/Weapons/MeleeTraceSubsystem.h"
+#include "Subsystems/DamageQueueSubsystem.h"
+#include "HUD/DamageLabelSubsystem.h"
+#include "DrawDebugHelpers.h"
+#include "Slash/SlashCollision.h"
 
 AWeapon::AWeapon()
 {
 	WeaponBox = CreateDefaultSubobject<UBoxComponent>(TEXT("Weapon Box"));
 	WeaponBox->SetupAttachment(GetRootComponent());
 
-	// Set Collision Presets for WeaponBox.
-	WeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	WeaponBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-	WeaponBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+	// Hits are found by sweeping the box shape, the box itself never collides.
+	WeaponBox->SetCollisionProfileName(SlashCollisionProfile::Weapon);
 
 	// Configure box trace objects.
 	BoxTraceStart = CreateDefaultSubobject<USceneComponent>(TEXT("Box Trace Start"));
@@ -27,43 +29,41 @@ AWeapon::AWeapon()
 
 	BoxTraceEnd = CreateDefaultSubobject<USceneComponent>(TEXT("Box Trace End"));
 	BoxTraceEnd->SetupAttachment(GetRootComponent());
-
-	// Create & attach `DamageHUDComponent` to root component of class.
-	DamageHUDComponent = CreateDefaultSubobject<UWeaponDamageComponent>(TEXT("DamageHUDComponent"));
-	DamageHUDComponent->SetupAttachment(GetRootComponent());
-
-	// Setup the `DamageHUDSphere` to control when to show/hide `DamageHUDComponent`.
-	DamageHUDSphere = CreateDefaultSubobject<USphereComponent>(TEXT("DamageHUDSphere"));
-	DamageHUDSphere->SetSphereRadius(500.0f);
-	DamageHUDSphere->SetupAttachment(GetRootComponent());
 }
 
 void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
-	WeaponBox->OnComponentBeginOverlap.AddDynamic(this, &AWeapon::OnBoxOverlap);
-
-	if (DamageHUDComponent)
+	// Weapons spawned for a character are equipped right away, only pickups lying in the world
+	// show their damage.
+	if (ItemState == EItemState::EIS_Hovering && GetOwner() == nullptr)
 	{
-		// Set weapon's damage HUD using `Damage` value.
-		DamageHUDComponent->SetWeaponDamage(Damage);
-
-		// Hide the damage HUD in the beginning.
-		HideDamageHUDComponent();
+		if (UDamageLabelSubsystem* DamageLabels = GetWorld()->GetSubsystem<UDamageLabelSubsystem>())
+		{
+			DamageLabels->RegisterWeapon(this);
+		}
 	}
+}
 
-	if (DamageHUDSphere)
+void AWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDamageLabelSubsystem* DamageLabels = GetWorld()->GetSubsystem<UDamageLabelSubsystem>())
 	{
-		DamageHUDSphere->OnComponentBeginOverlap.AddDynamic(this, &AWeapon::OnDamageHUDSphereOverlap);
-		DamageHUDSphere->OnComponentEndOverlap.AddDynamic(this, &AWeapon::OnDamageHUDSphereEndOverlap);
+		DamageLabels->UnregisterWeapon(this);
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AWeapon::Equip(USceneComponent* InParent, FName InSocketName, AActor* NewOwner, APawn* NewInstigator)
 {
 	ItemState = EItemState::EIS_Equipped;
 
+	// Equipped weapons are no longer pickups.
+	UnregisterAsPickup();
+	StopHovering();
+
 	SetOwner(NewOwner);
 	SetInstigator(NewInstigator);
 
@@ -78,11 +78,10 @@ void AWeapon::Equip(USceneComponent* InParent, FName InSocketName, AActor* NewOw
 	// Disable Niagara particle effect
 	DeactivateEmbers();
 
-	// Remove the damage HUD detection sphere & component attached with weapon.
-	if (DamageHUDSphere)
+	// Remove the damage HUD component attached with weapon, if it was ever shown.
+	if (UDamageLabelSubsystem* DamageLabels = GetWorld()->GetSubsystem<UDamageLabelSubsystem>())
 	{
-		DamageHUDSphere->DestroyComponent();
-		DamageHUDSphere = nullptr;
+		DamageLabels->UnregisterWeapon(this);
 	}
 	if (DamageHUDComponent)
 	{
@@ -127,16 +126,10 @@ void AWeapon::AttachMeshToSocket(USceneComponent* InParent, const FName& InSocke
 
 bool AWeapon::ActorIsSameType(AActor* OtherActor)
 {
-	return 
-		(
-			GetOwner()->ActorHasTag(FName("Enemy")) && OtherActor->ActorHasTag(FName("Enemy"))
-		) ||
-		(
-			GetOwner()->ActorHasTag(FName("EngageableTarget")) && OtherActor->ActorHasTag(FName("EngageableTarget"))
-		);
+	return ABaseCharacter::AreSameFaction(GetOwner(), OtherActor);
 }
 
-void AWeapon::ExecuteGetHit(FHitResult& BoxHit)
+void AWeapon::ExecuteGetHit(const FHitResult& BoxHit)
 {
 	IHitInterface* HitInterface = Cast<IHitInterface>(BoxHit.GetActor());
 	if (HitInterface)
@@ -145,6 +138,18 @@ void AWeapon::ExecuteGetHit(FHitResult& BoxHit)
 	}
 }
 
+void AWeapon::SetDamageHUDVisible(bool bVisible)
+{
+	if (bVisible)
+	{
+		ShowDamageHUDComponent();
+	}
+	else
+	{
+		HideDamageHUDComponent();
+	}
+}
+
 void AWeapon::HideDamageHUDComponent()
 {
 	if (DamageHUDComponent)
@@ -155,77 +160,111 @@ void AWeapon::HideDamageHUDComponent()
 
 void AWeapon::ShowDamageHUDComponent()
 {
+	if (DamageHUDComponent == nullptr && DamageHUDComponentClass)
+	{
+		// Create & attach `DamageHUDComponent` the first time it's needed, its class defaults bring
+		// the widget class, draw size, space & relative location.
+		DamageHUDComponent = NewObject<UWeaponDamageComponent>(this, DamageHUDComponentClass, TEXT("DamageHUDComponent"));
+		DamageHUDComponent->SetupAttachment(GetRootComponent());
+		DamageHUDComponent->RegisterComponent();
+
+		// Set weapon's damage HUD using `Damage` value.
+		DamageHUDComponent->SetWeaponDamage(Damage);
+	}
+
 	if (DamageHUDComponent)
 	{
 		DamageHUDComponent->SetVisibility(true);
 	}
 }
 
-void AWeapon::BoxTrace(FHitResult& BoxHit)
+void AWeapon::SetHitDetectionEnabled(bool bEnabled)
 {
-	const FVector Start = BoxTraceStart->GetComponentLocation();
-	const FVector End = BoxTraceEnd->GetComponentLocation();
+	UMeleeTraceSubsystem* MeleeTraces = GetWorld() ? GetWorld()->GetSubsystem<UMeleeTraceSubsystem>() : nullptr;
+
+	if (bEnabled)
+	{
+		HitRegistry.BeginSwing();
+		if (MeleeTraces)
+		{
+			MeleeTraces->BeginSwing(this);
+		}
+	}
+	else if (MeleeTraces)
+	{
+		MeleeTraces->EndSwing(this);
+	}
+}
 
-	TArray<AActor*> ActorsToIgnore;
+FTransform AWeapon::GetBladeTransform() const
+{
+	return BoxTraceStart->GetComponentTransform();
+}
 
-	// Add weapon itself to be ignored.
-	ActorsToIgnore.Add(this);
+void AWeapon::GetSweep(const FTransform& BladeTransform, FVector& OutStart, FVector& OutEnd, FQuat& OutRotation) const
+{
+	const FVector BladeEnd = BoxTraceStart->GetComponentTransform().InverseTransformPosition(BoxTraceEnd->GetComponentLocation());
 
-	// Add weapon owner to be ignored.
-	ActorsToIgnore.Add(GetOwner());
+	OutStart = BladeTransform.GetLocation();
+	OutEnd = BladeTransform.TransformPosition(BladeEnd);
+	OutRotation = BladeTransform.GetRotation();
 
-	for (AActor* Actor : IgnoreActors)
+	if (bShowBoxDebug)
 	{
-		ActorsToIgnore.AddUnique(Actor);
+		DrawDebugSweptBox(GetWorld(), OutStart, OutEnd, OutRotation.Rotator(), BoxTraceExtent, FColor::Red, false, 5.0f);
 	}
+}
+
+void AWeapon::GetSweepQuery(FCollisionShape& OutShape, FCollisionQueryParams& OutQueryParams) const
+{
+	OutShape = FCollisionShape::MakeBox(BoxTraceExtent);
 
-	UKismetSystemLibrary::BoxTraceSingle(
-		this,
-		Start,
-		End,
-		BoxTraceExtent,
-		BoxTraceStart->GetComponentRotation(),
-		ETraceTypeQuery::TraceTypeQuery1,
-		false,
-		ActorsToIgnore,
-		bShowBoxDebug ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-		BoxHit,
-		true
-	);
-	IgnoreActors.AddUnique(BoxHit.GetActor());
+	// Add weapon itself & its owner to be ignored.
+	OutQueryParams.AddIgnoredActor(this);
+	OutQueryParams.AddIgnoredActor(GetOwner());
 }
 
-void AWeapon::OnBoxOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AWeapon::OnSweepHit(const FHitResult& BoxHit, uint32 SwingId)
 {
-	if (ActorIsSameType(OtherActor)) return;
+	AActor* HitActor = BoxHit.GetActor();
 
-	FHitResult BoxHit;
-	BoxTrace(BoxHit);
+	// Sub-steps & async sweeps of the same swing find the same actors again, async results of an
+	// earlier swing may still come in.
+	if (!HitRegistry.RegisterHit(SwingId, HitActor)) return;
 
-	if (BoxHit.GetActor())
-	{
-		if (ActorIsSameType(BoxHit.GetActor())) return;
+	if (ActorIsSameType(HitActor) || GetInstigator() == nullptr) return;
 
-		UGameplayStatics::ApplyDamage(BoxHit.GetActor(), Damage, GetInstigator()->GetController(), this, UDamageType::StaticClass());
-		ExecuteGetHit(BoxHit);
-		CreateFields(BoxHit.ImpactPoint);
+	if (bShowBoxDebug)
+	{
+		DrawDebugPoint(GetWorld(), BoxHit.ImpactPoint, 15.0f, FColor::Green, false, 5.0f);
 	}
-}
 
-void AWeapon::OnDamageHUDSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	if (OtherActor->ActorHasTag(FName("EngageableTarget")))
+	// Resolved at the end of the frame, together with the other hits on the same actor.
+	if (UDamageQueueSubsystem* DamageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
 	{
-		// Show damage HUD on the weapon.
-		ShowDamageHUDComponent();
+		DamageQueue->QueueHit(HitActor, Damage, this, BoxHit.ImpactPoint);
+		return;
 	}
+
+	UGameplayStatics::ApplyDamage(HitActor, Damage, GetInstigator()->GetController(), this, UDamageType::StaticClass());
+	ExecuteGetHit(BoxHit);
+	ApplyImpactFields(BoxHit.ImpactPoint);
 }
 
-void AWeapon::OnDamageHUDSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AWeapon::ApplyImpactFields(const FVector& FieldLocation)
 {
-	if (OtherActor->ActorHasTag(FName("EngageableTarget")))
+	UFieldPoolSubsystem* FieldPool = GetWorld()->GetSubsystem<UFieldPoolSubsystem>();
+	if (FieldPool == nullptr) return;
+
+	// Hand built field graphs of weapon Blueprints go through the same budget & pooled component.
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AWeapon, CreateFields)))
 	{
-		// Hide damage HUD from the weapon.
-		HideDamageHUDComponent();
+		if (UFieldSystemComponent* FieldComponent = FieldPool->ReserveImpactFields(FieldLocation, ImpactFields.Radius))
+		{
+			CreateFields(FieldLocation, FieldComponent);
+		}
+		return;
 	}
+
+	FieldPool->ApplyImpactFields(FieldLocation, ImpactFields);
 }
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/DamageQueueSubsystem.h"
+#include "Items/Weapons/Weapon.h"
+#include "Interfaces/HitInterface.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Resolution"), STAT_DamageResolution, STATGROUP_SlashCombat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits Queued"), STAT_HitsQueued, STATGROUP_SlashCombat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Victims Resolved"), STAT_VictimsResolved, STATGROUP_SlashCombat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Victims Pending"), STAT_VictimsPending, STATGROUP_SlashCombat);
+
+static TAutoConsoleVariable<int32> CVarMaxDamageVictimsPerFrame(
+	TEXT("slash.Combat.MaxDamageVictimsPerFrame"),
+	0,
+	TEXT("Maximum number of hit victims resolved per frame, the others are resolved in the next frames.\n")
+	TEXT("0: No limit (default)."),
+	ECVF_Default
+);
+
+void UDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_VictimsPending, PendingVictims.Num());
+	if (PendingVictims.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_DamageResolution);
+	SLASH_PERF_SCOPE(ESPS_Damage);
+
+	const int32 MaxVictims = CVarMaxDamageVictimsPerFrame.GetValueOnGameThread();
+	const int32 NumVictims = MaxVictims > 0 ? FMath::Min(MaxVictims, PendingVictims.Num()) : PendingVictims.Num();
+
+	// Taken out before resolving, reactions may queue new hits for the next frame.
+	TArray<FPendingDamage> Victims(PendingVictims.GetData(), NumVictims);
+	PendingVictims.RemoveAt(0, NumVictims, false);
+
+	for (const FPendingDamage& PendingDamage : Victims)
+	{
+		ResolveDamage(PendingDamage);
+	}
+
+	INC_DWORD_STAT_BY(STAT_VictimsResolved, NumVictims);
+	SLASH_PERF_COUNT(ESPS_Damage, NumVictims);
+}
+
+TStatId UDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	PendingVictims.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDamageQueueSubsystem::QueueHit(AActor* Victim, float Damage, AWeapon* Weapon, const FVector& ImpactPoint)
+{
+	if (Victim == nullptr) return;
+
+	INC_DWORD_STAT(STAT_HitsQueued);
+
+	FPendingDamage* PendingDamage = PendingVictims.FindByPredicate([Victim](const FPendingDamage& Other) { return Other.Victim == Victim; });
+	if (PendingDamage == nullptr)
+	{
+		PendingDamage = &PendingVictims.AddDefaulted_GetRef();
+		PendingDamage->Victim = Victim;
+		PendingDamage->Weapon = Weapon;
+		PendingDamage->Hitter = Weapon ? Weapon->GetOwner() : nullptr;
+		PendingDamage->ImpactPoint = ImpactPoint;
+
+		const APawn* Instigator = Weapon ? Weapon->GetInstigator() : nullptr;
+		PendingDamage->InstigatorController = Instigator ? Instigator->GetController() : nullptr;
+	}
+
+	PendingDamage->Damage += Damage;
+	PendingDamage->NumHits++;
+}
+
+bool UDamageQueueSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDamageQueueSubsystem::ResolveDamage(const FPendingDamage& PendingDamage)
+{
+	AActor* Victim = PendingDamage.Victim.Get();
+	if (Victim == nullptr) return;
+
+	AWeapon* Weapon = PendingDamage.Weapon.Get();
+	UGameplayStatics::ApplyDamage(Victim, PendingDamage.Damage, PendingDamage.InstigatorController.Get(), Weapon, UDamageType::StaticClass());
+
+	// The hitter may be gone since, e.g. killed by another hit resolved before, react to its weapon then.
+	AActor* Hitter = PendingDamage.Hitter.IsValid() ? PendingDamage.Hitter.Get() : Weapon;
+	if (Hitter && Victim->Implements<UHitInterface>())
+	{
+		IHitInterface::Execute_GetHit(Victim, PendingDamage.ImpactPoint, Hitter);
+	}
+
+	if (Weapon)
+	{
+		Weapon->ApplyImpactFields(PendingDamage.ImpactPoint);
+	}
+}
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/FieldPoolSubsystem.h"
+#include "Breakable/BreakableActor.h"
+#include "Field/FieldSystemComponent.h"
+#include "Field/FieldSystemObjects.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Fields Applied"), STAT_ImpactFieldsApplied, STATGROUP_SlashCombat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Fields Skipped"), STAT_ImpactFieldsSkipped, STATGROUP_SlashCombat);
+
+static TAutoConsoleVariable<int32> CVarMaxFieldsPerFrame(
+	TEXT("slash.Combat.MaxFieldsPerFrame"),
+	4,
+	TEXT("Maximum number of weapon impact fields applied per frame, the others are skipped.\n")
+	TEXT("0: No limit."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarFieldMinSpacing(
+	TEXT("slash.Combat.FieldMinSpacing"),
+	100.0f,
+	TEXT("Impact fields closer than this to another field applied in the same frame are skipped."),
+	ECVF_Default
+);
+
+void UFieldPoolSubsystem::Deinitialize()
+{
+	Breakables.Empty();
+	BreakableLocations.Empty();
+	BreakableRadii.Empty();
+	FieldLocations.Empty();
+
+	FieldActor = nullptr;
+	FieldComponent = nullptr;
+	StrainFalloff = nullptr;
+	ForceFalloff = nullptr;
+	ForceDirection = nullptr;
+	Force = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UFieldPoolSubsystem::RegisterBreakable(ABreakableActor* Breakable)
+{
+	if (Breakable == nullptr || Breakables.Contains(Breakable)) return;
+
+	FVector Origin;
+	FVector Extent;
+	Breakable->GetActorBounds(false, Origin, Extent);
+
+	// Breakables don't move until broken, their pieces stay around the bounds.
+	Breakables.Add(Breakable);
+	BreakableLocations.Add(Origin);
+	BreakableRadii.Add(Extent.Size());
+}
+
+void UFieldPoolSubsystem::UnregisterBreakable(ABreakableActor* Breakable)
+{
+	const int32 Index = Breakables.IndexOfByKey(Breakable);
+	if (Index == INDEX_NONE) return;
+
+	Breakables.RemoveAtSwap(Index, 1, false);
+	BreakableLocations.RemoveAtSwap(Index, 1, false);
+	BreakableRadii.RemoveAtSwap(Index, 1, false);
+}
+
+bool UFieldPoolSubsystem::ApplyImpactFields(const FVector& Location, const FImpactFieldSettings& Settings)
+{
+	UFieldSystemComponent* Component = ReserveImpactFields(Location, Settings.Radius);
+	if (Component == nullptr) return false;
+
+	StrainFalloff->SetRadialFalloff(Settings.StrainMagnitude, 0.0f, 1.0f, 0.0f, Settings.Radius, Location, EFieldFalloffType::Field_FallOff_None);
+	Component->ApplyPhysicsField(true, EFieldPhysicsType::Field_ExternalClusterStrain, nullptr, StrainFalloff);
+
+	ForceFalloff->SetRadialFalloff(1.0f, 0.0f, 1.0f, 0.0f, Settings.Radius, Location, EFieldFalloffType::Field_FallOff_None);
+	ForceDirection->SetRadialVector(Settings.ForceMagnitude, Location);
+	Force->SetOperatorField(1.0f, ForceFalloff, ForceDirection, EFieldOperationType::Field_Multiply);
+	Component->ApplyPhysicsField(true, EFieldPhysicsType::Field_LinearForce, nullptr, Force);
+
+	return true;
+}
+
+UFieldSystemComponent* UFieldPoolSubsystem::ReserveImpactFields(const FVector& Location, float Radius)
+{
+	if (!HasBreakableWithin(Location, Radius) || !ReserveField(Location))
+	{
+		INC_DWORD_STAT(STAT_ImpactFieldsSkipped);
+		return nullptr;
+	}
+
+	UFieldSystemComponent* Component = GetFieldComponent();
+	if (Component)
+	{
+		INC_DWORD_STAT(STAT_ImpactFieldsApplied);
+	}
+	return Component;
+}
+
+bool UFieldPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UFieldPoolSubsystem::HasBreakableWithin(const FVector& Location, float Radius) const
+{
+	for (int32 Index = 0; Index < BreakableLocations.Num(); Index++)
+	{
+		if (FVector::DistSquared(BreakableLocations[Index], Location) <= FMath::Square(Radius + BreakableRadii[Index]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UFieldPoolSubsystem::ReserveField(const FVector& Location)
+{
+	if (FieldsFrame != GFrameCounter)
+	{
+		FieldsFrame = GFrameCounter;
+		FieldLocations.Reset();
+	}
+
+	const int32 MaxFields = CVarMaxFieldsPerFrame.GetValueOnGameThread();
+	if (MaxFields > 0 && FieldLocations.Num() >= MaxFields) return false;
+
+	const double MinSpacingSquared = FMath::Square(CVarFieldMinSpacing.GetValueOnGameThread());
+	for (const FVector& FieldLocation : FieldLocations)
+	{
+		if (FVector::DistSquared(FieldLocation, Location) < MinSpacingSquared) return false;
+	}
+
+	FieldLocations.Add(Location);
+	return true;
+}
+
+UFieldSystemComponent* UFieldPoolSubsystem::GetFieldComponent()
+{
+	if (FieldComponent) return FieldComponent;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	FieldActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	if (FieldActor == nullptr) return nullptr;
+
+	// Fields are transient commands positioned by their nodes, one component serves all impacts.
+	FieldComponent = NewObject<UFieldSystemComponent>(FieldActor, TEXT("ImpactFields"));
+	FieldActor->SetRootComponent(FieldComponent);
+	FieldComponent->RegisterComponent();
+
+	StrainFalloff = NewObject<URadialFalloff>(this);
+	ForceFalloff = NewObject<URadialFalloff>(this);
+	ForceDirection = NewObject<URadialVector>(this);
+	Force = NewObject<UOperatorField>(this);
+
+	return FieldComponent;
+}
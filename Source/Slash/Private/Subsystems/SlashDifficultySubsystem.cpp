@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/SlashDifficultySubsystem.h"
+
+void USlashDifficultySubsystem::SetDifficulty(EGameDifficulty NewDifficulty)
+{
+	if (Difficulty == NewDifficulty) return;
+
+	Difficulty = NewDifficulty;
+	OnDifficultyChanged.Broadcast(Difficulty);
+}
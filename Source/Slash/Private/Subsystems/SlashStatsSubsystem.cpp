@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/SlashStatsSubsystem.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSlashStats, Log, All);
+
+static TAutoConsoleVariable<int32> CVarStatsOverlay(
+	TEXT("slash.Stats.Overlay"),
+	0,
+	TEXT("Show the milliseconds & counts per frame of each Slash gameplay system on screen.\n")
+	TEXT("0: Off (default), nothing is collected unless slash.Stats.LogInterval is set."),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarStatsLogInterval(
+	TEXT("slash.Stats.LogInterval"),
+	0.0f,
+	TEXT("Seconds between two logs of the average milliseconds & counts per frame of each Slash gameplay system.\n")
+	TEXT("0: Off (default)."),
+	ECVF_Default
+);
+
+// Seconds between two refreshes of the overlay, so its values can be read.
+static constexpr double StatsOverlayRefreshInterval = 0.5;
+
+// On screen message key of the first overlay line, the next lines use the keys after it.
+static constexpr int32 StatsOverlayFirstKey = 0x5147;
+
+void USlashStatsSubsystem::Tick(float DeltaTime)
+{
+#if !UE_BUILD_SHIPPING
+	const bool bOverlay = CVarStatsOverlay.GetValueOnGameThread() != 0;
+	const float LogInterval = CVarStatsLogInterval.GetValueOnGameThread();
+
+	if (!bOverlay && LogInterval <= 0.0f)
+	{
+		if (bCollecting)
+		{
+			bCollecting = false;
+			FSlashPerf::RemoveCollector();
+			OverlayWindow.Reset();
+			LogWindow.Reset();
+		}
+		return;
+	}
+
+	// The first frame after enabling is partial, start from the next one.
+	if (!bCollecting)
+	{
+		bCollecting = true;
+		FSlashPerf::AddCollector();
+		LastSnapshot = FSlashPerfSnapshot::Take();
+		return;
+	}
+
+	const FSlashPerfSnapshot Snapshot = FSlashPerfSnapshot::Take();
+	const FSlashPerfSnapshot Frame = Snapshot - LastSnapshot;
+	LastSnapshot = Snapshot;
+
+	if (bOverlay)
+	{
+		OverlayWindow.AddFrame(Frame, DeltaTime);
+		if (OverlayWindow.FrameSeconds >= StatsOverlayRefreshInterval)
+		{
+			ShowOverlay();
+			OverlayWindow.Reset();
+		}
+	}
+
+	if (LogInterval > 0.0f)
+	{
+		LogWindow.AddFrame(Frame, DeltaTime);
+		if (LogWindow.FrameSeconds >= LogInterval)
+		{
+			WriteLog();
+			LogWindow.Reset();
+		}
+	}
+#endif
+}
+
+TStatId USlashStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USlashStatsSubsystem, STATGROUP_Tickables);
+}
+
+void USlashStatsSubsystem::Deinitialize()
+{
+	if (bCollecting)
+	{
+		bCollecting = false;
+		FSlashPerf::RemoveCollector();
+	}
+
+	Super::Deinitialize();
+}
+
+bool USlashStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USlashStatsSubsystem::ShowOverlay()
+{
+	if (GEngine == nullptr || OverlayWindow.NumFrames == 0) return;
+
+	// Lines are replaced on every refresh & disappear shortly after the overlay is turned off.
+	const float Duration = static_cast<float>(StatsOverlayRefreshInterval * 2.0);
+	const double FrameMs = OverlayWindow.FrameSeconds * 1000.0 / OverlayWindow.NumFrames;
+
+	GEngine->AddOnScreenDebugMessage(StatsOverlayFirstKey, Duration, FColor::Yellow,
+		FString::Printf(TEXT("Slash  Frame %.2f ms (%.0f FPS)"), FrameMs, FrameMs > 0.0 ? 1000.0 / FrameMs : 0.0));
+
+	for (int32 Index = 0; Index < FSlashPerf::NumSystems; Index++)
+	{
+		GEngine->AddOnScreenDebugMessage(StatsOverlayFirstKey + Index + 1, Duration, FColor::Yellow,
+			FString::Printf(TEXT("%-17s %6.2f ms  %6.1f"),
+				FSlashPerf::GetSystemName(Index),
+				OverlayWindow.Seconds[Index] * 1000.0 / OverlayWindow.NumFrames,
+				static_cast<double>(OverlayWindow.Counts[Index]) / OverlayWindow.NumFrames));
+	}
+}
+
+void USlashStatsSubsystem::WriteLog()
+{
+	if (LogWindow.NumFrames == 0) return;
+
+	FString Line = FString::Printf(TEXT("Frame %.2f ms"), LogWindow.FrameSeconds * 1000.0 / LogWindow.NumFrames);
+	for (int32 Index = 0; Index < FSlashPerf::NumSystems; Index++)
+	{
+		Line += FString::Printf(TEXT(" | %s %.2f ms (%.1f)"),
+			FSlashPerf::GetSystemName(Index),
+			LogWindow.Seconds[Index] * 1000.0 / LogWindow.NumFrames,
+			static_cast<double>(LogWindow.Counts[Index]) / LogWindow.NumFrames);
+	}
+
+	UE_LOG(LogSlashStats, Log, TEXT("%s"), *Line);
+}
+
+void USlashStatsSubsystem::FStatsWindow::AddFrame(const FSlashPerfSnapshot& Frame, float DeltaTime)
+{
+	for (int32 Index = 0; Index < FSlashPerf::NumSystems; Index++)
+	{
+		Seconds[Index] += Frame.Seconds[Index];
+		Counts[Index] += Frame.Counts[Index];
+	}
+	FrameSeconds += DeltaTime;
+	NumFrames++;
+}
+
+void USlashStatsSubsystem::FStatsWindow::Reset()
+{
+	*this = FStatsWindow();
+}
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/SpatialHashSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Slash/SlashStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spatial Hash Rebuild"), STAT_SpatialHashRebuild, STATGROUP_SlashAI);
+DECLARE_CYCLE_STAT(TEXT("Spatial Hash Query"), STAT_SpatialHashQuery, STATGROUP_SlashAI);
+
+static TAutoConsoleVariable<float> CVarSpatialHashCellSize(
+	TEXT("slash.Spatial.CellSize"),
+	1000.0f,
+	TEXT("Edge length of the cells of the gameplay spatial hash, in unreal units."),
+	ECVF_Default
+);
+
+void USpatialHashSubsystem::Tick(float DeltaTime)
+{
+	RefreshIfStale();
+}
+
+TStatId USpatialHashSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USpatialHashSubsystem, STATGROUP_Tickables);
+}
+
+void USpatialHashSubsystem::Deinitialize()
+{
+	Actors.Empty();
+	Locations.Empty();
+	Categories.Empty();
+	CellKeys.Empty();
+	ActorIndices.Empty();
+	SortedEntries.Empty();
+	CellRanges.Empty();
+	UnsortedEntries.Empty();
+	RemovedEntries.Empty();
+
+	Super::Deinitialize();
+}
+
+void USpatialHashSubsystem::RegisterActor(AActor* Actor, ESpatialCategory::Type Category)
+{
+	if (Actor == nullptr) return;
+
+	if (const int32* ExistingIndex = ActorIndices.Find(Actor))
+	{
+		Categories[*ExistingIndex] = Category;
+		return;
+	}
+
+	const int32 Index = Actors.Add(Actor);
+	Locations.Add(Actor->GetActorLocation());
+	Categories.Add(Category);
+	CellKeys.Add(GetCellKey(GetCell(Locations[Index])));
+	ActorIndices.Add(Actor, Index);
+
+	// Found by queries until the next rebuild sorts it into its cell.
+	UnsortedEntries.Add(Index);
+}
+
+void USpatialHashSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!ActorIndices.RemoveAndCopyValue(Actor, Index)) return;
+
+	// Keep the slot until the next rebuild, so the sorted entries of this frame stay valid.
+	Actors[Index] = nullptr;
+	Categories[Index] = ESpatialCategory::ESC_None;
+	RemovedEntries.Add(Index);
+}
+
+bool USpatialHashSubsystem::IsRegistered(const AActor* Actor) const
+{
+	return ActorIndices.Contains(Actor);
+}
+
+void USpatialHashSubsystem::QueryRadius(const FVector& Origin, double Radius, uint8 CategoryMask, TArray<AActor*>& OutActors)
+{
+	RefreshIfStale();
+
+	SCOPE_CYCLE_COUNTER(STAT_SpatialHashQuery);
+
+	const double RadiusSquared = FMath::Square(Radius);
+	const FIntPoint MinCell = GetCell(Origin - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Origin + FVector(Radius));
+
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; CellY++)
+		{
+			const FIntPoint* Range = CellRanges.Find(GetCellKey(FIntPoint(CellX, CellY)));
+			if (Range == nullptr) continue;
+
+			for (int32 SortedIndex = Range->X; SortedIndex < Range->X + Range->Y; SortedIndex++)
+			{
+				const int32 Index = SortedEntries[SortedIndex];
+				if ((Categories[Index] & CategoryMask) != 0 &&
+					FVector::DistSquared(Locations[Index], Origin) <= RadiusSquared)
+				{
+					OutActors.Add(Actors[Index]);
+				}
+			}
+		}
+	}
+
+	for (const int32 Index : UnsortedEntries)
+	{
+		if ((Categories[Index] & CategoryMask) != 0 &&
+			FVector::DistSquared(Locations[Index], Origin) <= RadiusSquared)
+		{
+			OutActors.Add(Actors[Index]);
+		}
+	}
+}
+
+bool USpatialHashSubsystem::IsWithinRange(const AActor* Source, const AActor* Target, double Radius)
+{
+	if (Source == nullptr || Target == nullptr) return false;
+
+	return GetDistanceSquared(Source, Target) <= FMath::Square(Radius);
+}
+
+double USpatialHashSubsystem::GetDistanceSquared(const AActor* Source, const AActor* Target)
+{
+	return FVector::DistSquared(GetCachedLocation(Source), GetCachedLocation(Target));
+}
+
+FVector USpatialHashSubsystem::GetCachedLocation(const AActor* Actor)
+{
+	if (Actor == nullptr) return FVector::ZeroVector;
+
+	RefreshIfStale();
+
+	const int32* Index = ActorIndices.Find(Actor);
+	return Index ? Locations[*Index] : Actor->GetActorLocation();
+}
+
+void USpatialHashSubsystem::RefreshIfStale()
+{
+	if (LastRefreshFrame != GFrameCounter)
+	{
+		LastRefreshFrame = GFrameCounter;
+		Rebuild();
+	}
+}
+
+bool USpatialHashSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USpatialHashSubsystem::Rebuild()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SpatialHashRebuild);
+
+	CellSize = FMath::Max(CVarSpatialHashCellSize.GetValueOnGameThread(), 100.0f);
+
+	// Free the slots of the actors unregistered since the last rebuild, highest first so every
+	// swapped in entry is a live one.
+	RemovedEntries.Sort(TGreater<int32>());
+	for (const int32 Index : RemovedEntries)
+	{
+		Actors.RemoveAtSwap(Index, 1, false);
+		Locations.RemoveAtSwap(Index, 1, false);
+		Categories.RemoveAtSwap(Index, 1, false);
+		CellKeys.RemoveAtSwap(Index, 1, false);
+
+		if (Actors.IsValidIndex(Index))
+		{
+			ActorIndices.Add(Actors[Index], Index);
+		}
+	}
+	RemovedEntries.Reset();
+	UnsortedEntries.Reset();
+
+	const int32 NumActors = Actors.Num();
+	for (int32 Index = 0; Index < NumActors; Index++)
+	{
+		if (const AActor* Actor = Actors[Index])
+		{
+			Locations[Index] = Actor->GetActorLocation();
+		}
+		CellKeys[Index] = GetCellKey(GetCell(Locations[Index]));
+	}
+
+	// Sort entries by cell so every cell is one contiguous range, no per-cell allocations needed.
+	SortedEntries.SetNumUninitialized(NumActors, false);
+	for (int32 Index = 0; Index < NumActors; Index++)
+	{
+		SortedEntries[Index] = Index;
+	}
+	SortedEntries.Sort([this](int32 A, int32 B) { return CellKeys[A] < CellKeys[B]; });
+
+	CellRanges.Reset();
+	for (int32 SortedIndex = 0; SortedIndex < NumActors; SortedIndex++)
+	{
+		const uint64 Key = CellKeys[SortedEntries[SortedIndex]];
+		FIntPoint& Range = CellRanges.FindOrAdd(Key, FIntPoint(SortedIndex, 0));
+		Range.Y++;
+	}
+}
+
+FIntPoint USpatialHashSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize)
+	);
+}
+
+uint64 USpatialHashSubsystem::GetCellKey(const FIntPoint& Cell)
+{
+	return (static_cast<uint64>(static_cast<uint32>(Cell.X)) << 32) | static_cast<uint64>(static_cast<uint32>(Cell.Y));
+}
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Tests/SlashTestWorld.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Slash/SlashCollision.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SlashCollisionProfilesTest
+{
+	/**
+	 * A player & an enemy standing next to each other with a weapon pickup at the player's feet, every
+	 * body set up like the game classes do, with the Slash profiles or like before them.
+	 * Capsules of the player & the enemy don't touch, so no pair depends on block/block responses.
+	 */
+	struct FScene
+	{
+		TArray<UPrimitiveComponent*> Components;
+
+		UPrimitiveComponent* PlayerCapsule = nullptr;
+		UPrimitiveComponent* EnemyCapsule = nullptr;
+		UPrimitiveComponent* Sensor = nullptr;
+		UPrimitiveComponent* Pickup = nullptr;
+	};
+
+	template<typename T>
+	T* AddComponent(UWorld* World, FScene& Scene, const FVector& Location, const FName& ProfileName)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+		T* Component = NewObject<T>(Actor);
+		Component->SetCollisionProfileName(ProfileName);
+		Actor->SetRootComponent(Component);
+		Component->RegisterComponent();
+		Scene.Components.Add(Component);
+		return Component;
+	}
+
+	UPrimitiveComponent* AddCharacter(UWorld* World, FScene& Scene, const FVector& Location, bool bSlashProfiles)
+	{
+		UCapsuleComponent* Capsule = AddComponent<UCapsuleComponent>(World, Scene, Location, UCollisionProfile::Pawn_ProfileName);
+		Capsule->InitCapsuleSize(34.0f, 88.0f);
+
+		// Stand-in for the skeletal mesh, as set up by `AEnemy()`: overlap events only before the Slash profiles.
+		UCapsuleComponent* Mesh = AddComponent<UCapsuleComponent>(World, Scene, Location, FName(TEXT("CharacterMesh")));
+		Mesh->InitCapsuleSize(40.0f, 88.0f);
+		Mesh->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
+		Mesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
+		Mesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
+		Mesh->SetGenerateOverlapEvents(!bSlashProfiles);
+
+		return Capsule;
+	}
+
+	FScene CreateScene(UWorld* World, bool bSlashProfiles)
+	{
+		// Default profile of shape components, used by all of them before the Slash profiles.
+		static const FName OverlapAllDynamic(TEXT("OverlapAllDynamic"));
+
+		FScene Scene;
+		Scene.PlayerCapsule = AddCharacter(World, Scene, FVector::ZeroVector, bSlashProfiles);
+		Scene.EnemyCapsule = AddCharacter(World, Scene, FVector(120.0, 0.0, 0.0), bSlashProfiles);
+
+		USphereComponent* Sensor = AddComponent<USphereComponent>(World, Scene, FVector::ZeroVector, bSlashProfiles ? SlashCollisionProfile::Sensor : OverlapAllDynamic);
+		Sensor->SetSphereRadius(150.0f);
+		Scene.Sensor = Sensor;
+
+		const FVector PickupLocation(0.0, 60.0, 0.0);
+		USphereComponent* Pickup = AddComponent<USphereComponent>(World, Scene, PickupLocation, bSlashProfiles ? SlashCollisionProfile::Pickup : OverlapAllDynamic);
+		Pickup->SetSphereRadius(64.0f);
+		Scene.Pickup = Pickup;
+
+		UBoxComponent* WeaponBox = AddComponent<UBoxComponent>(World, Scene, FVector(120.0, 0.0, 0.0), bSlashProfiles ? SlashCollisionProfile::Weapon : OverlapAllDynamic);
+		WeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+		if (bSlashProfiles)
+		{
+			// Inactive hitbox, see `UHitboxComponent::CreateCapsule()`.
+			UCapsuleComponent* Hitbox = AddComponent<UCapsuleComponent>(World, Scene, FVector(120.0, 0.0, 0.0), SlashCollisionProfile::Hitbox);
+			Hitbox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			Hitbox->SetGenerateOverlapEvents(false);
+		}
+		else
+		{
+			// The damage HUD sphere pickup weapons had before `UDamageLabelSubsystem`.
+			USphereComponent* DamageHUDSphere = AddComponent<USphereComponent>(World, Scene, PickupLocation, OverlapAllDynamic);
+			DamageHUDSphere->SetSphereRadius(500.0f);
+		}
+
+		for (UPrimitiveComponent* Component : Scene.Components)
+		{
+			Component->UpdateOverlaps();
+		}
+		return Scene;
+	}
+
+	int32 CountOverlapPairs(const FScene& Scene)
+	{
+		int32 NumOverlaps = 0;
+		for (const UPrimitiveComponent* Component : Scene.Components)
+		{
+			TArray<UPrimitiveComponent*> OverlappingComponents;
+			Component->GetOverlappingComponents(OverlappingComponents);
+			NumOverlaps += OverlappingComponents.Num();
+		}
+
+		// Both components of a pair report it.
+		return NumOverlaps / 2;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCollisionProfilesOverlapPairsTest, "Slash.Collision.ProfilesOverlapPairs",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FCollisionProfilesOverlapPairsTest::RunTest(const FString& Parameters)
+{
+	using namespace SlashCollisionProfilesTest;
+
+	int32 NumLegacyPairs = 0;
+	{
+		FSlashTestWorld World;
+		NumLegacyPairs = CountOverlapPairs(CreateScene(World.Get(), false));
+	}
+
+	FSlashTestWorld World;
+	const FScene Scene = CreateScene(World.Get(), true);
+	const int32 NumSlashPairs = CountOverlapPairs(Scene);
+
+	AddInfo(FString::Printf(TEXT("Overlap pairs: %d with the default profiles, %d with the Slash profiles."), NumLegacyPairs, NumSlashPairs));
+
+	// Only pawn capsules overlap pickups & sensors: player/pickup, player/sensor & enemy/sensor.
+	TestEqual(TEXT("Overlap pairs with the Slash profiles"), NumSlashPairs, 3);
+	TestTrue(TEXT("Player capsule overlaps the pickup"), Scene.PlayerCapsule->IsOverlappingComponent(Scene.Pickup));
+	TestTrue(TEXT("Enemy capsule overlaps the sensor"), Scene.EnemyCapsule->IsOverlappingComponent(Scene.Sensor));
+	TestFalse(TEXT("Sensor overlaps the pickup"), Scene.Sensor->IsOverlappingComponent(Scene.Pickup));
+	TestTrue(TEXT("Fewer overlap pairs than with the default profiles"), NumSlashPairs < NumLegacyPairs);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Tests/SlashTestWorld.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Interfaces/HitInterface.h"
+#include "UObject/UObjectArray.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyPoolKillRespawnTest, "Slash.AI.EnemyPool.KillRespawnCycles",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FEnemyPoolKillRespawnTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumCycles = 1000;
+
+	FSlashTestWorld World;
+	UEnemyPoolSubsystem* EnemyPool = World->GetSubsystem<UEnemyPoolSubsystem>();
+	if (!TestNotNull(TEXT("Enemy pool subsystem"), EnemyPool)) return false;
+
+	const FTransform SpawnTransform(FVector(0.0, 0.0, 100.0));
+	AEnemy* const FirstEnemy = EnemyPool->AcquireEnemy(AEnemy::StaticClass(), SpawnTransform);
+	if (!TestNotNull(TEXT("Spawned enemy"), FirstEnemy)) return false;
+
+	// Kill: a hit without hitter always kills, then the end of `DeathLifeSpan` hands it to the pool.
+	auto KillAndRespawn = [EnemyPool, &SpawnTransform](AEnemy* Enemy)
+	{
+		IHitInterface::Execute_GetHit(Enemy, Enemy->GetActorLocation(), nullptr);
+		EnemyPool->ReleaseEnemy(Enemy);
+		return EnemyPool->AcquireEnemy(AEnemy::StaticClass(), SpawnTransform);
+	};
+
+	// One cycle first, so lazily created objects (controller, timers, delegates) already exist.
+	AEnemy* Enemy = KillAndRespawn(FirstEnemy);
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	int32 NumReused = 0;
+	for (int32 Cycle = 0; Cycle < NumCycles; Cycle++)
+	{
+		Enemy = KillAndRespawn(Enemy);
+		NumReused += Enemy == FirstEnemy ? 1 : 0;
+	}
+
+	TestEqual(TEXT("Enemies reused from the pool"), NumReused, NumCycles);
+	TestEqual(TEXT("Pooled enemies"), EnemyPool->GetNumPooledEnemies(), 0);
+
+	// No new object means nothing for the garbage collector to collect.
+	TestEqual(TEXT("Objects created by the kill/respawn cycles"), GUObjectArray.GetObjectArrayNumMinusAvailable() - NumObjects, 0);
+
+	return true;
+}
+
+#endif
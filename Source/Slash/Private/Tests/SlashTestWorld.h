@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Empty game world for automation tests, with the Slash world subsystems & begun play.
+ * Destroyed & garbage collected with the scope.
+ */
+class FSlashTestWorld
+{
+public:
+	FSlashTestWorld()
+	{
+		// A game world, so the Slash subsystems are created like in a packaged game.
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SlashTestWorld"));
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		const FURL URL;
+		World->InitializeActorsForPlay(URL);
+
+		// Without game mode to start the match, begin play directly.
+		World->GetWorldSettings()->NotifyBeginPlay();
+	}
+
+	~FSlashTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UWorld* operator->() const { return World; }
+	UWorld* Get() const { return World; }
+
+private:
+	UWorld* World;
+};
+
+#endif
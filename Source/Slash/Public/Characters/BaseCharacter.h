@@ -10,8 +10,12 @@
 
 class AWeapon;
 class UAttributeComponent;
+class UHitboxComponent;
 class UAnimMontage;
 class UNiagaraSystem;
+class ABaseCharacter;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCharacterDied, ABaseCharacter*);
 
 UCLASS()
 class SLASH_API ABaseCharacter : public ACharacter, public IHitInterface
@@ -22,8 +26,23 @@ public:
 	ABaseCharacter();
 	virtual void Tick(float DeltaTime) override;
 
+	// Broadcast once this character dies, e.g. to let enemies drop it as combat target.
+	FOnCharacterDied OnCharacterDied;
+
+	/** Faction & status */
+
+	// `ECombatFlags` of `Actor`, read from its `Tags` only if it isn't a character.
+	static uint8 GetCombatFlags(const AActor* Actor);
+
+	// Whether both actors are of the same faction, i.e. mustn't hit each other.
+	static bool AreSameFaction(const AActor* Actor, const AActor* OtherActor);
+
+	FORCEINLINE bool HasCombatFlags(uint8 Flags) const { return (CombatFlags & Flags) == Flags; }
+	FORCEINLINE UHitboxComponent* GetHitboxes() const { return Hitboxes; }
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/** Combat */
 
@@ -71,6 +90,10 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 	UAttributeComponent* Attributes;
 
+	// Bodies hit by weapons, instead of the skeletal mesh.
+	UPROPERTY(VisibleAnywhere)
+	UHitboxComponent* Hitboxes;
+
 	UPROPERTY(BlueprintReadOnly, Category = Combat)
 	AActor* CombatTarget;
 
@@ -80,6 +103,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly)
 	TEnumAsByte<EDeathPose> DeathPose;
 
+	// `ECombatFlags` bitmask.
+	uint8 CombatFlags = ECombatFlags::ECF_None;
+
 private:
 	void PlayMontageSection(UAnimMontage* Montage, const FName& SectionName);
 	int32 PlayRandomMontageSection(UAnimMontage* Montage, const TArray<FName>& SectionNames);
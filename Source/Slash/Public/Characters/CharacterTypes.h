@@ -45,5 +45,31 @@ enum class EEnemyState : uint8
 	EES_Patrolling UMETA(DisplayName = "Patrolling"),
 	EES_Chasing UMETA(DisplayName = "Chasing"),
 	EES_Attacking UMETA(DisplayName = "Attacking"),
-	EES_Engaged UMETA(DisplayName = "Engaged")
+	EES_Engaged UMETA(DisplayName = "Engaged"),
+	EES_Orbiting UMETA(DisplayName = "Orbiting")
 };
+
+UENUM(BlueprintType)
+enum class EGameDifficulty : uint8
+{
+	EGD_Easy UMETA(DisplayName = "Easy"),
+	EGD_Normal UMETA(DisplayName = "Normal"),
+	EGD_Hard UMETA(DisplayName = "Hard")
+};
+
+/*
+* Faction & status of a combatant, combined as a bitmask & compared instead of scanning the actor `Tags`.
+* The matching tags are still added for designers.
+*/
+namespace ECombatFlags
+{
+	enum Type : uint8
+	{
+		ECF_None = 0,
+		ECF_Enemy = 1 << 0,  // Tag "Enemy"
+		ECF_EngageableTarget = 1 << 1,  // Tag "EngageableTarget", the player
+		ECF_Dead = 1 << 2,  // Tag "Dead"
+
+		ECF_Factions = ECF_Enemy | ECF_EngageableTarget
+	};
+}
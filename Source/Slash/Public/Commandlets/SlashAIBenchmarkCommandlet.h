@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SlashAIBenchmarkCommandlet.generated.h"
+
+class AEnemy;
+class APawn;
+
+/**
+ * Headless stress benchmark of the enemy AI.
+ * Loads a map, spawns `-Enemies` enemies patrolling between random targets & a scripted player pawn
+ * circling through them, ticks the world for `-Frames` fixed steps & writes one CSV row per frame:
+ * game thread time, time in the AI hot paths (see `FSlashPerf`) & memory use.
+ *
+ * `-Compare=100,500,2000` runs every count twice instead, with the per actor `AEnemy::Tick` &
+ * the batched `UEnemyAISubsystem` path (`slash.AI.BatchEnemyTick`), writes one CSV per run &
+ * a `<Output>_Comparison.md` table of the average frame times.
+ *
+ * UnrealEditor-Cmd Slash.uproject -run=SlashAIBenchmark -nullrhi -unattended
+ *     [-Map=/Game/Maps/TestMap] [-EnemyClass=/Game/.../BP_Enemy.BP_Enemy_C] [-Enemies=100 | -Compare=100,500,2000]
+ *     [-Frames=600] [-FPS=30] [-Radius=3000] [-Seed=0] [-Output=<Saved>/Benchmarks/AIBenchmark.csv]
+ */
+UCLASS()
+class SLASH_API USlashAIBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USlashAIBenchmarkCommandlet();
+
+	/** <UCommandlet> */
+	virtual int32 Main(const FString& Params) override;
+	/** </UCommandlet> */
+
+private:
+	struct FRunSettings
+	{
+		FString MapName = TEXT("/Game/Maps/TestMap");
+		TSubclassOf<AEnemy> EnemyClass;
+		int32 NumFrames = 600;
+		int32 FramesPerSecond = 30;
+		int32 Seed = 0;
+		float Radius = 3000.0f;
+	};
+
+	// Averages per frame of one run.
+	struct FRunResult
+	{
+		double GameThreadMs = 0.0;
+		double EnemyAIMs = 0.0;  // `AEnemy::Tick` + `UEnemyAISubsystem` batch tick
+		double PeakUsedPhysicalMB = 0.0;
+	};
+
+	bool RunBenchmark(const FRunSettings& Settings, int32 NumEnemies, FString& OutCsv, FRunResult& OutResult);
+	int32 RunComparison(const FRunSettings& Settings, const FString& CompareCounts, const FString& OutputPath);
+
+	UWorld* LoadWorld(const FString& MapName);
+	void DestroyWorld(UWorld* World);
+
+	void SpawnEnemies(UWorld* World, TSubclassOf<AEnemy> EnemyClass, int32 NumEnemies, const FVector& Center, float Radius);
+	APawn* SpawnPlayer(UWorld* World, const FVector& Location);
+	FVector GetRandomLocation(UWorld* World, const FVector& Center, float Radius);
+
+	FRandomStream RandomStream;
+};
@@ -26,6 +26,10 @@ public:
 	void AddSouls(int32 NumberOfSouls);
 	void AddGold(int32 AmountOfGold);
 	void AddHealth(float HealthToAdd);
+	void SetHealth(float NewHealth);
+
+	// Restore health & stamina to their values at `BeginPlay()`, used when recycling pooled actors.
+	void ResetAttributes();
 
 protected:
 	virtual void BeginPlay() override;
@@ -61,6 +65,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Actor Attributes")
 	float StaminaRegenRate = 8.0f;
 
+	// Values of `Health` & `Stamina` at `BeginPlay()`, restored by `ResetAttributes()`.
+	float InitialHealth = 0.0f;
+	float InitialStamina = 0.0f;
+
 public:
 	FORCEINLINE int32 GetGold() const { return Gold; }
 	FORCEINLINE int32 GetSouls() const { return Souls; }
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HitboxComponent.generated.h"
+
+class UCapsuleComponent;
+class USkeletalMeshComponent;
+
+/*
+* One capsule of `UHitboxComponent`, placed along `StartBone` -> `EndBone`, or centered on `StartBone`.
+*/
+USTRUCT(BlueprintType)
+struct FHitboxCapsule
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName StartBone;
+
+	// Leave empty to center the capsule on `StartBone`.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName EndBone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius = 10.0f;
+
+	// Only used without `EndBone`, otherwise the capsule spans both bones.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float HalfHeight = 15.0f;
+};
+
+/**
+ * A few capsules (head, torso, limbs) following the bones of the owner's mesh, the only bodies of the
+ * character hit by weapon sweeps (`ECC_WeaponTrace`), so the skeletal mesh needs no overlap events.
+ * Capsules have no collision & aren't moved until `UMeleeTraceSubsystem` activates them, while a
+ * swinging weapon is nearby.
+ * Capsules whose bones aren't found in the mesh are skipped, if none is left a single capsule
+ * follows the owner's capsule.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API UHitboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHitboxComponent();
+
+	// Enable or disable the collision of the capsules.
+	void SetHitboxesActive(bool bActive);
+
+	// Move the capsules to the current bone transforms, only while active.
+	void UpdateHitboxes();
+
+	FORCEINLINE bool AreHitboxesActive() const { return bHitboxesActive; }
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	void CreateHitboxes();
+	UCapsuleComponent* CreateCapsule(const FName& Name, float Radius, float HalfHeight);
+
+	UPROPERTY(EditAnywhere, Category = "Hitboxes")
+	TArray<FHitboxCapsule> Capsules;
+
+	UPROPERTY(Transient)
+	USkeletalMeshComponent* Mesh;
+
+	// Created capsules, index `i` of every array below belongs to `CapsuleComponents[i]`.
+	UPROPERTY(Transient)
+	TArray<UCapsuleComponent*> CapsuleComponents;
+
+	TArray<int32> StartBoneIndices;  // `INDEX_NONE`: follows the owner's capsule
+	TArray<int32> EndBoneIndices;    // `INDEX_NONE`: centered on the start bone
+
+	bool bHitboxesActive = false;
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Characters/CharacterTypes.h"
+#include "AttackTokenSubsystem.generated.h"
+
+class AEnemy;
+class USlashDifficultySubsystem;
+
+/**
+ * Limits how many enemies attack the same target at once.
+ * An enemy reaching its attack radius asks for one of the target's attack tokens; without a free
+ * token it orbits the target until a token is released, first come first served.
+ * The number of tokens per target depends on the difficulty of `USlashDifficultySubsystem` & is read
+ * from the game config.
+ */
+UCLASS(Config = Game)
+class SLASH_API UAttackTokenSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UWorldSubsystem> */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	/** </UWorldSubsystem> */
+
+	// Grant `Enemy` a token of `Target`, otherwise queue it & return false.
+	// Enemies already holding a token of `Target` keep it.
+	bool RequestToken(AEnemy* Enemy, AActor* Target);
+
+	// Remove `Enemy` from the queue it's waiting in, if any.
+	void CancelRequest(AEnemy* Enemy);
+
+	// Give back the token held by `Enemy`, if any, the next queued enemy gets it.
+	void ReleaseToken(AEnemy* Enemy);
+
+	// Sets the difficulty of `USlashDifficultySubsystem`, so it's kept after map travel.
+	UFUNCTION(BlueprintCallable, Category = Combat)
+	void SetDifficulty(EGameDifficulty NewDifficulty);
+
+	// Concurrent attackers allowed per target, `slash.AI.AttackTokens.MaxAttackers` overrides the difficulty.
+	int32 GetMaxAttackers() const;
+
+	FORCEINLINE EGameDifficulty GetDifficulty() const { return Difficulty; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FAttackTokens
+	{
+		TWeakObjectPtr<AActor> Target;
+		TArray<TWeakObjectPtr<AEnemy>> Holders;
+		TArray<TWeakObjectPtr<AEnemy>> Waiting;
+	};
+
+	FAttackTokens& FindOrAddTokens(AActor* Target);
+
+	// Follow the difficulty of the game instance, once it's available.
+	void BindDifficulty();
+	void OnDifficultyChanged(EGameDifficulty NewDifficulty);
+
+	// Hand the free tokens of `Target` to the enemies waiting for them.
+	void GrantWaitingEnemies(const AActor* Target);
+	void UpdateStats() const;
+
+	TArray<FAttackTokens> TargetTokens;
+
+	EGameDifficulty Difficulty = EGameDifficulty::EGD_Normal;
+	FDelegateHandle DifficultyChangedHandle;
+	TWeakObjectPtr<USlashDifficultySubsystem> DifficultySubsystem;
+
+	UPROPERTY(Config)
+	int32 MaxAttackersEasy = 1;
+
+	UPROPERTY(Config)
+	int32 MaxAttackersNormal = 2;
+
+	UPROPERTY(Config)
+	int32 MaxAttackersHard = 4;
+};
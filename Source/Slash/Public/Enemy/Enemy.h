@@ -6,14 +6,22 @@
 #include "Characters/BaseCharacter.h"
 #include "Interfaces/HitInterface.h"
 #include "Characters/CharacterTypes.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "AITypes.h"
+#include "Navigation/PathFollowingComponent.h"
 #include "Enemy.generated.h"
 
 class UHealthBarComponent;
 class AAIController;
-class UPawnSensingComponent;
 class ASoul;
 class AHealth;
 class AWeapon;
+class UEnemyAISubsystem;
+class USpatialHashSubsystem;
+class UPursuitFlowFieldSubsystem;
+class UPatrolRouteSubsystem;
+class UAttackTokenSubsystem;
+class UEnemyCrowdSubsystem;
 
 UCLASS()
 class SLASH_API AEnemy : public ABaseCharacter
@@ -26,6 +34,7 @@ public:
 	/** <AActor> */
 	virtual void Tick(float DeltaTime) override;
 	float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Destroyed() override;
 	/** </AActor> */
 
@@ -33,6 +42,26 @@ public:
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 	/** </IHitInterface> */
 
+	/** Pooling, see `UEnemyPoolSubsystem` */
+
+	// Take the enemy out of the game without destroying it: timers, movement, AI & subsystem
+	// registrations are stopped, the enemy & its weapon are hidden with collision disabled.
+	void DeactivateForPool();
+
+	// Bring a deactivated enemy back as if it was just spawned at `SpawnTransform`:
+	// full health & stamina, not dead, patrolling, no combat target, health bar hidden,
+	// capsule, mesh & movement restored, weapon shown but not damaging, registered with the AI.
+	// The actor, its components, its controller & its weapon are kept as they are.
+	void ResetFromPool(const FTransform& SpawnTransform);
+
+	void SetPatrolTargets(const TArray<AActor*>& NewPatrolTargets);
+
+	/** Crowd, see `UEnemyCrowdSubsystem` */
+
+	// Continue the patrol of a promoted crowd proxy, after `ResetFromPool()`: same patrol targets,
+	// heading to `CurrentPatrolTarget` once `WaitTime` is over, with the proxy's health.
+	void RestoreCrowdState(const TArray<AActor*>& NewPatrolTargets, AActor* CurrentPatrolTarget, float Health, float WaitTime);
+
 protected:
 	/** <AActor> */
 	virtual void BeginPlay() override;
@@ -54,14 +83,60 @@ protected:
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
 	EEnemyState EnemyState = EEnemyState::EES_Patrolling;
 
+	void SetEnemyState(EEnemyState NewState);
+
 private:
+	friend class UEnemyAISubsystem;
+	friend class UEnemyPerceptionSubsystem;
+	friend class ULineOfSightScheduler;
+	friend class UPursuitFlowFieldSubsystem;
+	friend class UAttackTokenSubsystem;
+	friend class UEnemyCrowdSubsystem;
+	friend struct FEnemyStateMachine;
 
 	/** AI Behavior */
 
 	void InitializeEnemy();
-	void CheckPatrolTarget();
-	void CheckCombatTarget();
+	void InitializeController();
+	void RegisterWithSubsystems();
+	void UnregisterFromSubsystems();
+	void DeathLifeSpanFinished();  // Callback for `DeathLifeSpanTimer`
+	void UpdateAI();  // Per-actor range checks, only used by `Tick()` when batching is disabled
+	AActor* GetAITarget() const;
+
+	// Run the transition of `FEnemyStateMachine` for `Event` in the current state, if any.
+	void HandleEnemyEvent(EEnemyEvent Event);
+
+	// Called when the combat target crosses one of the radii, raises the matching event.
+	void OnRangeBandChanged(EEnemyRangeBand NewBand);
+	EEnemyRangeBand ComputeRangeBand();
+
+	void SetCombatTarget(AActor* NewTarget);
+	void OnCombatTargetDied(ABaseCharacter* DeadCharacter);
+
+	// Callback for `OnRequestFinished` of the path following component of `EnemyController`
+	void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result);
+
 	void PatrolTimerFinished();  // Callback for `PatrolTimer`
+	void AttackTimerFinished();  // Callback for `AttackTimer`
+
+	/** State machine transitions, see `FEnemyStateMachine` */
+
+	void OnTargetSeen();
+	void OnPatrolTargetReached();
+	void ResumePatrol();
+	void ChaseFromAttack();
+	void GiveUpCombat();
+	void LoseInterestWhileEngaged();
+	void FinishAttack();
+	void OnDamaged();
+	void RequestAttack();
+	void AttackFromOrbit();
+
+	// Called by `UAttackTokenSubsystem` once a queued request for an attack token is granted.
+	void OnAttackTokenGranted();
+	void StartOrbiting();
+
 	void HideHealthBar();
 	void ShowHealthBar();
 	void LoseInterest();
@@ -74,23 +149,31 @@ private:
 	bool IsAttacking();
 	bool IsDead();
 	bool IsEngaged();
+	bool IsOrbiting();
 	void ClearPatrolTimer();
 	void StartAttackTimer();
 	void ClearAttackTimer();
 	bool InTargetRange(AActor* Target, double Radius);
 	void MoveToTarget(AActor* Target);
+	void MoveToPatrolTarget();
 	AActor* ChoosePatrolTarget();
 	void SpawnDefaultWeapon();
 
-	// Callback for OnPawnSeen in UPawnSensingComponent
-	UFUNCTION()
+	// Called by `ULineOfSightScheduler` when `SeenPawn` is inside the vision cone & visible.
 	void PawnSeen(APawn* SeenPawn);
 
 	UPROPERTY(VisibleAnywhere)
 	UHealthBarComponent* HealthBarComponent;
 
-	UPROPERTY(VisibleAnywhere)
-	UPawnSensingComponent* PawnSensing;
+	// Upper bound of `SightRadius`, used to gather candidates around a seen pawn.
+	static constexpr double MaxSightRadius = 8000.0;
+
+	UPROPERTY(EditAnywhere, Category = Perception, meta = (ClampMin = "0.0", ClampMax = "8000.0"))
+	float SightRadius = 4000.0f;
+
+	// Half angle of the vision cone, in degrees.
+	UPROPERTY(EditAnywhere, Category = Perception, meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float PeripheralVisionAngle = 45.0f;
 
 	UPROPERTY(EditAnywhere, Category = Combat)
 	TSubclassOf<AWeapon> WeaponClass;
@@ -104,9 +187,41 @@ private:
 	UPROPERTY(EditAnywhere, Category = Combat)
 	double AcceptanceRadius = 50.0f;
 
+	// Distance kept from the combat target while waiting for an attack token.
+	UPROPERTY(EditAnywhere, Category = Combat)
+	double OrbitRadius = 300.0f;
+
 	UPROPERTY()
 	AAIController* EnemyController;
 
+	UPROPERTY()
+	UEnemyAISubsystem* AISubsystem;
+
+	UPROPERTY()
+	USpatialHashSubsystem* SpatialHash;
+
+	UPROPERTY()
+	UPursuitFlowFieldSubsystem* PursuitSubsystem;
+
+	UPROPERTY()
+	UPatrolRouteSubsystem* PatrolRoutes;
+
+	UPROPERTY()
+	UAttackTokenSubsystem* AttackTokens;
+
+	UPROPERTY()
+	UEnemyCrowdSubsystem* Crowd;
+
+	// Index of this enemy in the arrays of `UEnemyAISubsystem`.
+	int32 AISlot = INDEX_NONE;
+
+	// Last known position of the combat target relative to the radii, used by `UpdateAI()`.
+	EEnemyRangeBand RangeBand = EEnemyRangeBand::ERB_Unknown;
+
+	// Character whose `OnCharacterDied` this enemy listens to.
+	TWeakObjectPtr<ABaseCharacter> ObservedCombatTarget;
+	FDelegateHandle CombatTargetDiedHandle;
+
 	// Current patrol target
 	UPROPERTY(EditInstanceOnly, Category = "AI Navigation")
 	AActor* PatrolTarget;
@@ -114,8 +229,9 @@ private:
 	UPROPERTY(EditInstanceOnly, Category = "AI Navigation")
 	TArray<AActor*> PatrolTargets;
 
-	UPROPERTY(EditAnywhere)
-	double PatrolRadius = 200.0f;
+	// Patrol target the enemy is standing at, start of the cached path to `PatrolTarget`.
+	UPROPERTY()
+	AActor* PatrolOrigin;
 
 	FTimerHandle PatrolTimer;
 
@@ -142,6 +258,13 @@ private:
 	UPROPERTY(EditAnywhere, Category = Combat)
 	float DeathLifeSpan = 8.0f;
 
+	// Hands the dead enemy over to `UEnemyPoolSubsystem` once `DeathLifeSpan` is over.
+	FTimerHandle DeathLifeSpanTimer;
+
+	// Collision settings at `BeginPlay()`, restored when the enemy is reused from the pool.
+	ECollisionEnabled::Type DefaultCapsuleCollision = ECollisionEnabled::QueryAndPhysics;
+	ECollisionEnabled::Type DefaultMeshCollision = ECollisionEnabled::QueryAndPhysics;
+
 	UPROPERTY(EditAnywhere, Category = Combat)
 	TSubclassOf<ASoul> SoulClass;
 
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Characters/CharacterTypes.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "EnemyAISubsystem.generated.h"
+
+class AEnemy;
+
+/*
+* Update rate buckets assigned to enemies by their significance to the players.
+*/
+enum class EEnemyAILOD : uint8
+{
+	EAL_EveryFrame,
+	EAL_Every4thFrame,
+	EAL_Every15thFrame,
+	EAL_Dormant
+};
+
+/**
+ * Owns the AI update of every `AEnemy` in the world.
+ * Hot per-enemy data is kept in parallel arrays (structure-of-arrays) and
+ * evaluated in one loop per frame, so individual enemies don't need to tick.
+ * Only enemies in combat are range checked, & they are only notified when their combat target
+ * crosses one of their radii. Patrolling enemies cost nothing until an event wakes them up.
+ * Enemies far away from, or not visible to, the players are updated less often.
+ */
+UCLASS()
+class SLASH_API UEnemyAISubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	// Keeps the cached state of `Enemy` in sync, called whenever `AEnemy::EnemyState` changes.
+	void SetEnemyState(const AEnemy* Enemy, EEnemyState NewState);
+
+	// True when enemies are updated by this subsystem instead of their own `Tick()`.
+	static bool IsBatchTickEnabled();
+
+	// Called by enemies every time an event ran a transition of `FEnemyStateMachine`.
+	void NotifyTransitionProcessed();
+
+	FORCEINLINE int32 GetNumEnemies() const { return Enemies.Num(); }
+	FORCEINLINE int32 GetTransitionsPerSecond() const { return TransitionsPerSecond; }
+	EEnemyAILOD GetEnemyLOD(const AEnemy* Enemy) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void UpdateSignificance();
+	void ScheduleUpdates();
+	void GatherEnemyLocations();
+	void EvaluateEnemies();
+	void DispatchDecisions();
+	void SetEnemyTicksEnabled(bool bEnabled);
+
+	// Enemy actors, index `i` of every array below belongs to `Enemies[i]`.
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	TArray<EEnemyState> States;
+	TArray<FVector> Locations;
+	TArray<FVector> TargetLocations;
+	TArray<bool> HasTarget;
+	TArray<EEnemyRangeBand> RangeBands;
+	TArray<double> CombatRadiiSquared;
+	TArray<double> AttackRadiiSquared;
+	TArray<EEnemyAILOD> LODs;
+	TArray<uint8> FramesUntilUpdate;
+
+	// Output of `ScheduleUpdates()`, enemies whose LOD allows an update this frame.
+	TArray<int32> DueEnemies;
+
+	// Output of `EvaluateEnemies()`, enemies whose combat target crossed a radius this frame.
+	TArray<int32> PendingDecisions;
+
+	// Time left until LOD buckets are re-evaluated.
+	float SignificanceCountdown = 0.0f;
+
+	// State machine transitions counted over the current second & the last complete one.
+	int32 TransitionsThisSecond = 0;
+	int32 TransitionsPerSecond = 0;
+	float TransitionsCountdown = 1.0f;
+
+	// Last known value of `slash.AI.BatchEnemyTick`, used to detect runtime switches.
+	bool bBatchTickActive = true;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Characters/CharacterTypes.h"
+#include "EnemyCrowdSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Hybrid representation of large enemy crowds.
+ * Enemies far away from every player only exist as a few values in parallel arrays (location,
+ * patrol progress, health, state) & patrol in straight lines in one cheap loop, without actor,
+ * mesh, movement component, controller or widget.
+ * Proxies coming within `slash.AI.Crowd.PromoteDistance` of a player are promoted to real `AEnemy`
+ * actors through `UEnemyPoolSubsystem`, patrolling enemies further than
+ * `slash.AI.Crowd.DemoteDistance` from every player are demoted back into proxies, whether they
+ * were placed in the level, spawned or promoted. Enemies in combat are never demoted.
+ */
+UCLASS()
+class SLASH_API UEnemyCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Add an enemy of `EnemyClass` to the crowd, as a proxy until a player comes close.
+	UFUNCTION(BlueprintCallable, Category = "Enemy Crowd")
+	void AddEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform, const TArray<AActor*>& PatrolTargets);
+
+	// Add/remove an enemy actor to/from the crowd, called by every enemy (placed or spawned) from
+	// its subsystem registration, so far away patrolling enemies are demoted into proxies.
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	// Turn an enemy of the crowd back into a proxy, returns false if it can't be demoted right now.
+	bool DemoteEnemy(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumProxies() const { return ProxyLocations.Num(); }
+	FORCEINLINE int32 GetNumPromotedEnemies() const { return PromotedEnemies.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCrowdRoute
+	{
+		TArray<TWeakObjectPtr<AActor>> Waypoints;
+		TArray<FVector> Locations;
+	};
+
+	void SimulateProxies(float DeltaTime);
+	void PromoteProxies();
+	void DemoteEnemies();
+	void PromoteProxy(int32 Index);
+	void RemoveProxy(int32 Index);
+
+	int32 FindOrAddRoute(const TArray<AActor*>& PatrolTargets);
+	static int32 ChooseNextWaypoint(const FCrowdRoute& Route, int32 CurrentWaypoint);
+	double GetMinPlayerDistanceSquared(const FVector& Location) const;
+	void GatherPlayerLocations();
+
+	TArray<FCrowdRoute> Routes;
+
+	/** Proxies, index `i` of every array below belongs to the same proxy */
+
+	TArray<TSubclassOf<AEnemy>> ProxyClasses;
+	TArray<FVector> ProxyLocations;
+	TArray<FRotator> ProxyRotations;
+	TArray<EEnemyState> ProxyStates;
+	TArray<float> ProxyHealths;
+	TArray<int32> ProxyRoutes;  // Index in `Routes`, `INDEX_NONE` without patrol
+	TArray<int32> ProxyWaypoints;  // Index of the current patrol target in the route
+	TArray<float> ProxyWaitTimes;  // Seconds left at the current patrol target
+	TArray<float> ProxySpeeds;
+	TArray<FVector2f> ProxyWaitRanges;  // X = `PatrolWaitMin`, Y = `PatrolWaitMax`
+
+	/** Enemies of the crowd currently being actors (placed, spawned or promoted), index `i` of both arrays belongs to the same enemy */
+
+	UPROPERTY()
+	TArray<AEnemy*> PromotedEnemies;
+
+	TArray<int32> PromotedRoutes;  // `INDEX_NONE`: found from the enemy's patrol targets when demoted
+
+	TArray<FVector> PlayerLocations;
+	float UpdateCountdown = 0.0f;
+};
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemy;
+class APawn;
+
+/**
+ * Vision of all enemies, replacing one `UPawnSensingComponent` per enemy.
+ * On every perception tick, each player pawn gathers the enemies around it from the spatial hash,
+ * tests all of their vision cones in one pass over packed arrays & queues line of sight checks
+ * for the enemies which could see it in `ULineOfSightScheduler`.
+ */
+UCLASS()
+class SLASH_API UEnemyPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** </UTickableWorldSubsystem> */
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void UpdatePerception();
+	void SenseTarget(APawn* Target);
+
+	// Time left until the next perception update.
+	float PerceptionCountdown = 0.0f;
+
+	/** Scratch buffers reused across updates, index `i` of every array belongs to `Candidates[i]` */
+
+	TArray<AActor*> NearbyActors;
+	TArray<AEnemy*> Candidates;
+	TArray<float> OffsetsX;
+	TArray<float> OffsetsY;
+	TArray<float> OffsetsZ;
+	TArray<float> ForwardsX;
+	TArray<float> ForwardsY;
+	TArray<float> ForwardsZ;
+	TArray<float> SightRadiiSquared;
+	TArray<float> CosPeripheralAngles;
+	TArray<float> DistancesSquared;
+	TArray<uint8> InVisionCone;
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Keeps dead enemies around instead of destroying them, so spawning an enemy can reuse the actor,
+ * its components, its AI controller & its equipped weapon.
+ * Released enemies are deactivated by `AEnemy::DeactivateForPool()` & brought back to their
+ * just spawned state by `AEnemy::ResetFromPool()`, see there for the reset contract.
+ */
+UCLASS()
+class SLASH_API UEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UWorldSubsystem> */
+	virtual void Deinitialize() override;
+	/** </UWorldSubsystem> */
+
+	// Whether dead enemies go back to the pool, see `slash.AI.EnemyPool`.
+	static bool IsPoolingEnabled();
+
+	// Reuse a pooled enemy of exactly `EnemyClass`, or spawn a new one if none is available.
+	// Spawn enemies at runtime through this, instead of `SpawnActor`, so dead ones are reused.
+	UFUNCTION(BlueprintCallable, Category = "Enemy Pool")
+	AEnemy* AcquireEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	// Deactivate `Enemy` & keep it for a later `AcquireEnemy()`, destroys it if the pool is full.
+	UFUNCTION(BlueprintCallable, Category = "Enemy Pool")
+	void ReleaseEnemy(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumPooledEnemies() const { return PooledEnemies.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Deactivated enemies ready to be reused, of any class.
+	UPROPERTY()
+	TArray<AEnemy*> PooledEnemies;
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+class AEnemy;
+
+/*
+* Events which can move an enemy from one `EEnemyState` to another.
+*/
+enum class EEnemyEvent : uint8
+{
+	EEE_TargetSeen,
+	EEE_PatrolTargetReached,
+	EEE_PatrolTimerExpired,
+	EEE_EnteredAttackRadius,
+	EEE_LeftAttackRadius,
+	EEE_LeftCombatRadius,
+	EEE_AttackTimerExpired,
+	EEE_AttackEnded,
+	EEE_Damaged,
+	EEE_TargetDied,
+	EEE_AttackTokenGranted,
+
+	EEE_MAX
+};
+
+/*
+* Where the combat target is, relative to the enemy's radii.
+*/
+enum class EEnemyRangeBand : uint8
+{
+	ERB_InsideAttackRadius,
+	ERB_InsideCombatRadius,
+	ERB_OutsideCombatRadius,
+
+	ERB_Unknown
+};
+
+/**
+ * Transition table of the enemy AI.
+ * Every (state, event) pair maps to the `AEnemy` method handling it, or to nothing when the
+ * event doesn't matter in that state. Enemies only do work when an event is raised.
+ */
+struct FEnemyStateMachine
+{
+	using FTransition = void (AEnemy::*)();
+
+	static FTransition GetTransition(EEnemyState State, EEnemyEvent Event);
+	static bool HasTransition(EEnemyState State, EEnemyEvent Event);
+
+	// Event raised when the combat target enters `Band`.
+	static EEnemyEvent GetRangeBandEvent(EEnemyRangeBand Band);
+
+	// States which react to the combat target crossing a radius, only these need range checks.
+	static bool IsRangeWatchedState(EEnemyState State);
+
+	// States in which an enemy keeps the attack token it was granted, see `UAttackTokenSubsystem`.
+	static bool CanHoldAttackToken(EEnemyState State);
+
+private:
+	static constexpr int32 NumStates = static_cast<int32>(EEnemyState::EES_Orbiting) + 1;
+	static constexpr int32 NumEvents = static_cast<int32>(EEnemyEvent::EEE_MAX);
+
+	static void BuildTransitionTable(FTransition (&Table)[NumStates][NumEvents]);
+	static void AddTransition(FTransition (&Table)[NumStates][NumEvents], EEnemyState State, EEnemyEvent Event, FTransition Transition);
+};
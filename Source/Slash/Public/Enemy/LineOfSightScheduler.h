@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "LineOfSightScheduler.generated.h"
+
+class AEnemy;
+class APawn;
+
+/**
+ * Queues the visibility checks of enemy perception & issues them as asynchronous traces,
+ * at most `slash.AI.LineOfSight.MaxTracesPerFrame` per frame, most urgent & longest waiting first.
+ * Results are delivered to `AEnemy::PawnSeen()` on the next frame.
+ */
+UCLASS()
+class SLASH_API ULineOfSightScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Queue a check whether `Enemy` can see `Target`, replacing any queued check of the same enemy.
+	void RequestLineOfSight(AEnemy* Enemy, APawn* Target, double DistanceSquared);
+
+	FORCEINLINE int32 GetNumQueuedRequests() const { return QueuedRequests.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FLineOfSightRequest
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TWeakObjectPtr<APawn> Target;
+
+		// Lower value is issued first, lowered further by the frames waited since `QueuedFrame`.
+		double Priority = 0.0;
+		uint64 QueuedFrame = 0;
+	};
+
+	void IssueTraces();
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	static double ComputePriority(const AEnemy* Enemy, double DistanceSquared);
+
+	TArray<FLineOfSightRequest> QueuedRequests;
+
+	// Requests whose trace has been issued, keyed by the `UserData` passed along with the trace.
+	TMap<uint32, FLineOfSightRequest> InFlightRequests;
+
+	// Enemies with a queued or in flight request, to avoid tracing the same enemy twice.
+	TSet<TWeakObjectPtr<AEnemy>> PendingEnemies;
+
+	FTraceDelegate TraceDelegate;
+	uint32 NextRequestId = 1;
+};
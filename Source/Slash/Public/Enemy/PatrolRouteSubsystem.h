@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NavigationSystemTypes.h"
+#include "PatrolRouteSubsystem.generated.h"
+
+class ANavigationData;
+struct FNavAgentProperties;
+
+/**
+ * Navigation paths between the patrol targets of enemies, computed once per pair of waypoints.
+ * Routes are registered by enemies at begin play, which finds the paths between every pair of
+ * their waypoints up front. Enemies then replay the cached path when walking from one waypoint
+ * to the next instead of pathfinding again.
+ * Paths are registered as active paths of the navigation data, so they are only invalidated
+ * when navmesh tiles they cross are rebuilt, & then repathed by the navigation data (or
+ * recomputed on their next use if that fails).
+ */
+UCLASS()
+class SLASH_API UPatrolRouteSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UWorldSubsystem> */
+	virtual void Deinitialize() override;
+	/** </UWorldSubsystem> */
+
+	// Compute the paths between every pair of `Waypoints` which isn't cached yet.
+	void RegisterRoute(const TArray<AActor*>& Waypoints, const FNavAgentProperties& AgentProperties);
+
+	// Up to date path from `From` to `To`, recomputed if its navmesh tiles changed. Null if there's no path.
+	FNavPathSharedPtr FindPath(const AActor* From, const AActor* To, const FNavAgentProperties& AgentProperties);
+
+	FORCEINLINE int32 GetNumCachedPaths() const { return CachedPaths.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPatrolPathKey
+	{
+		const AActor* From = nullptr;
+		const AActor* To = nullptr;
+		ANavigationData* NavData = nullptr;
+
+		bool operator==(const FPatrolPathKey& Other) const
+		{
+			return From == Other.From && To == Other.To && NavData == Other.NavData;
+		}
+
+		friend uint32 GetTypeHash(const FPatrolPathKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.From), GetTypeHash(Key.To)), GetTypeHash(Key.NavData));
+		}
+	};
+
+	FNavPathSharedPtr ComputePath(const FPatrolPathKey& Key, const FNavAgentProperties& AgentProperties);
+
+	TMap<FPatrolPathKey, FNavPathSharedPtr> CachedPaths;
+};
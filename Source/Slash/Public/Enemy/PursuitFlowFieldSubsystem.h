@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PursuitFlowFieldSubsystem.generated.h"
+
+class AEnemy;
+class ANavigationData;
+class UNavigationSystemV1;
+
+/**
+ * Shared pursuit of a moving target by any number of enemies.
+ * Instead of every chasing enemy repathing toward the same goal actor, one flow field is
+ * computed per target on a grid around it, using the navmesh to know which cells are walkable.
+ * Each chaser only samples the field at its own cell & steers toward the cheaper neighbour,
+ * so the pathfinding cost stays the same whether 5 or 100 enemies chase the target.
+ * Chasers outside of the field, or on a cell the target can't be reached from, fall back to
+ * a regular `MoveTo()` until they enter it again. Enemies waiting for an attack token orbit
+ * the target instead of following the field.
+ */
+UCLASS()
+class SLASH_API UPursuitFlowFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Whether chasing enemies use shared flow fields, see `slash.AI.FlowFieldPursuit`.
+	static bool IsFlowFieldPursuitEnabled();
+
+	// Make `Enemy` follow the flow field of `Target`, replacing any previous pursuit of `Enemy`.
+	void StartPursuit(AEnemy* Enemy, AActor* Target);
+	void StopPursuit(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumChasers() const { return Chasers.Num(); }
+	FORCEINLINE int32 GetNumFlowFields() const { return FlowFields.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FFlowField
+	{
+		TWeakObjectPtr<AActor> Target;
+
+		// World cell of the grid's corner & of the target when the field was built.
+		FIntPoint Origin = FIntPoint::ZeroValue;
+		FIntPoint TargetCell = FIntPoint::ZeroValue;
+
+		// Steps to reach the target from every cell of the grid, `MAX_uint16` if unreachable.
+		TArray<uint16> Costs;
+
+		float RebuildCountdown = 0.0f;
+		int32 NumChasers = 0;
+		bool bDirty = true;
+	};
+
+	struct FChaser
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TWeakObjectPtr<AActor> Target;
+
+		// Whether the enemy currently falls back to path following.
+		bool bPathFollowing = false;
+	};
+
+	void UpdateFlowFields(float DeltaTime);
+	void BuildFlowField(FFlowField& Field);
+	void SteerChasers();
+
+	// Direction circling the target at the orbit radius of `Enemy`.
+	static FVector ComputeOrbitDirection(AEnemy* Enemy, const FVector& Location, const FVector& TargetLocation);
+
+	// Direction toward the target from `Location`, false if the field can't lead there.
+	bool SampleFlowField(const FFlowField& Field, const FVector& Location, FVector& OutDirection) const;
+
+	bool IsCellWalkable(const UNavigationSystemV1* NavSys, const FIntPoint& Cell, double Height);
+	FIntPoint GetCell(const FVector& Location) const;
+	FVector GetCellCenter(const FIntPoint& Cell, double Height) const;
+	int32 GetFieldIndex(const FFlowField& Field, const FIntPoint& Cell) const;
+
+	FFlowField* FindFlowField(const AActor* Target);
+
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	TArray<FFlowField> FlowFields;
+	TArray<FChaser> Chasers;
+
+	// Walkability of world cells per height band (`Z` of the key, see `WalkableBandHeight`),
+	// shared by all fields & kept until the navmesh changes.
+	TMap<FIntVector, bool> WalkableCells;
+
+	// Height of the bands walkability is cached for, so cells on slopes or several floors don't
+	// reuse the answer of a query made from another height.
+	static constexpr double WalkableBandHeight = 300.0;
+
+	// Scratch queue of the breadth first search.
+	TArray<int32> OpenCells;
+
+	double CellSize = 200.0;
+	int32 GridHalfExtent = 24;
+};
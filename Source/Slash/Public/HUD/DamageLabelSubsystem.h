@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageLabelSubsystem.generated.h"
+
+class AWeapon;
+
+/**
+ * Shows the damage label of the weapons lying in the world while the player is close to them.
+ * Every `slash.HUD.DamageLabelUpdateInterval` seconds, the player locations are queried against the
+ * pickups of `USpatialHashSubsystem`, labels are only shown or hidden when they change.
+ * Replaces a detector sphere per weapon, no physics shape is involved.
+ */
+UCLASS()
+class SLASH_API UDamageLabelSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Show the label of `Weapon` whenever the player is within its `DamageHUDRadius`.
+	void RegisterWeapon(AWeapon* Weapon);
+
+	// Hide the label of `Weapon` for good, e.g. once it's equipped.
+	void UnregisterWeapon(AWeapon* Weapon);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void UpdateLabels();
+
+	TSet<TWeakObjectPtr<AWeapon>> RegisteredWeapons;
+	TArray<TWeakObjectPtr<AWeapon>> VisibleWeapons;
+
+	// Largest `DamageHUDRadius` of the registered weapons, the radius of the queries.
+	double MaxRadius = 0.0;
+
+	TArray<AActor*> NearbyActors;
+	TArray<TWeakObjectPtr<AWeapon>> InRangeWeapons;
+	float UpdateCountdown = 0.0f;
+};
@@ -7,9 +7,10 @@
 #include "WeaponDamageComponent.generated.h"
 
 /**
- * 
+ * Damage label of a weapon lying in the world, configure the widget class, draw size, space &
+ * relative location in a Blueprint subclass set as the weapon's `DamageHUDComponentClass`.
  */
-UCLASS()
+UCLASS(Blueprintable, ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class SLASH_API UWeaponDamageComponent : public UWidgetComponent
 {
 	GENERATED_BODY()
@@ -24,12 +24,33 @@ class SLASH_API AItem : public AActor
 public:
 	// Sets default values for this actor's properties
 	AItem();
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+
+	/** Pooling, see `UPickupPoolSubsystem` */
+
+	// Take the item out of the game without destroying it: hidden, no collision, no hovering,
+	// not a pickup anymore & its effect stopped.
+	virtual void DeactivateForPool();
+
+	// Bring a deactivated item back at `SpawnTransform` as a hovering pickup, its value must be set before.
+	virtual void ResetFromPool(const FTransform& SpawnTransform);
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Add/remove this item from the pickups tracked by `USpatialHashSubsystem`.
+	void RegisterAsPickup();
+	void UnregisterAsPickup();
+
+	// Add/remove this item from the items moved by `UPickupHoverSubsystem`.
+	void StartHovering();
+	void StopHovering();
+
+	// Hand a collected pickup over to `UPickupPoolSubsystem`, instead of `Destroy()`.
+	void ReleaseToPool();
+
+	friend class UPickupHoverSubsystem;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sine Parameters")
 	float Amplitude = 0.25f;
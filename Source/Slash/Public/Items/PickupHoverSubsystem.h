@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupHoverSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Moves all hovering items in one loop, items themselves don't tick.
+ * The bob offset is computed from the time since the item started hovering, instead of being
+ * accumulated every frame, so items which weren't rendered recently are simply skipped.
+ * Items drifting down (souls) are always moved, their pickup sphere must follow.
+ */
+UCLASS()
+class SLASH_API UPickupHoverSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Start bobbing `Item` around its current location.
+	void StartHovering(AItem* Item);
+	void StopHovering(AItem* Item);
+
+	// Move the hover location of `Item` down at `Rate` (negative) until `FloorZ`.
+	void SetDrift(AItem* Item, float Rate, double FloorZ);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void RemoveItemAt(int32 Index);
+
+	// Hovering items, index `i` of every array below belongs to `Items[i]`.
+	TArray<TWeakObjectPtr<AItem>> Items;
+	TArray<FVector> BaseLocations;
+	TArray<float> StartTimes;
+	TArray<float> BobScales;
+	TArray<float> BobRates;
+	TArray<float> DriftRates;
+	TArray<double> DriftFloorZs;
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Items/Item.h"
+#include "PickupPoolSubsystem.generated.h"
+
+USTRUCT()
+struct FPooledPickups
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AItem*> Pickups;
+};
+
+/**
+ * Keeps collected pickups (souls, health, treasures) around instead of destroying them, so dropping
+ * a pickup can reuse the actor & its mesh, sphere & Niagara components.
+ * Pickups are pooled by exact class, deactivated by `AItem::DeactivateForPool()` & brought back by
+ * `AItem::ResetFromPool()`. Their value is applied before they're activated, so a player standing
+ * at the drop location can't collect a stale value.
+ * Pickups of the classes enemies & breakables can drop are spawned ahead of time, in their `BeginPlay()`.
+ */
+UCLASS()
+class SLASH_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UWorldSubsystem> */
+	virtual void Deinitialize() override;
+	/** </UWorldSubsystem> */
+
+	// Reuse a pooled pickup of exactly `PickupClass`, or spawn a new one. `Setup` applies its value
+	// before it's activated.
+	AItem* AcquirePickup(TSubclassOf<AItem> PickupClass, const FTransform& SpawnTransform, AActor* Owner, TFunctionRef<void(AItem*)> Setup);
+
+	template<typename T>
+	T* AcquirePickup(TSubclassOf<T> PickupClass, const FTransform& SpawnTransform, AActor* Owner, TFunctionRef<void(T*)> Setup)
+	{
+		return Cast<T>(AcquirePickup(PickupClass.Get(), SpawnTransform, Owner, [&Setup](AItem* Pickup) { Setup(CastChecked<T>(Pickup)); }));
+	}
+
+	// Deactivate `Pickup` & keep it for a later `AcquirePickup()`, destroys it if the pool is full.
+	void ReleasePickup(AItem* Pickup);
+
+	// Spawn deactivated pickups of `PickupClass` until `slash.Items.PickupPool.PrewarmCount` are pooled.
+	void PrewarmPickups(TSubclassOf<AItem> PickupClass);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	AItem* SpawnPickup(TSubclassOf<AItem> PickupClass, const FTransform& SpawnTransform, AActor* Owner, TFunctionRef<void(AItem*)> Setup);
+	void UpdatePooledStat();
+
+	// Deactivated pickups ready to be reused, by class.
+	UPROPERTY()
+	TMap<TSubclassOf<AItem>, FPooledPickups> PooledPickups;
+};
@@ -13,16 +13,19 @@ UCLASS()
 class SLASH_API ASoul : public AItem
 {
 	GENERATED_BODY()
-	
-public:
-	virtual void Tick(float DeltaTime) override;
 
+public:
+	virtual void ResetFromPool(const FTransform& SpawnTransform) override;
+	
 protected:
 	virtual void BeginPlay() override;
 
 	virtual void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) override;
 
 private:
+	// Find the ground below the soul & drift down towards it.
+	void StartDrifting();
+
 	UPROPERTY(EditAnywhere, Category = "Soul Properties")
 	int32 Souls;
 
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "MeleeTraceSubsystem.generated.h"
+
+class AWeapon;
+class UHitboxComponent;
+
+/**
+ * Runs the hit detection sweeps of all swinging weapons together, once per frame.
+ * The blade is swept from its pose of the previous frame to its current one in sub-steps, so fast
+ * swings can't pass through a target between two frames, even at a low tick rate. Every sub-step
+ * is one multi-hit sweep returning all actors along the blade.
+ * Sweeps only hit `ECC_WeaponTrace` blockers: the hitboxes of the characters near a swinging weapon,
+ * activated & moved to their bones before sweeping, and breakables.
+ * With `slash.Combat.AsyncMeleeTraces` the sweeps go to the async scene queries running in parallel
+ * with the next frame & hits are applied when they complete, otherwise they run right away.
+ */
+UCLASS()
+class SLASH_API UMeleeTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Sweep the blade of `Weapon` every frame until `EndSwing()`.
+	void BeginSwing(AWeapon* Weapon);
+
+	// Sweep the rest of the swing up to the current pose, then stop sweeping `Weapon`.
+	void EndSwing(AWeapon* Weapon);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FSwing
+	{
+		TWeakObjectPtr<AWeapon> Weapon;
+		FTransform PreviousBladeTransform;
+	};
+
+	struct FInFlightSweep
+	{
+		TWeakObjectPtr<AWeapon> Weapon;
+		uint32 SwingId = 0;
+		int32 NumPendingSteps = 0;
+	};
+
+	// Activate the hitboxes of the characters near a swinging weapon, deactivate the others.
+	void UpdateHitboxes();
+
+	// Sweep from the previous to the current blade pose of the swing.
+	void SweepSwing(FSwing& Swing, bool bAsync);
+
+	void OnAsyncSweepCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	TArray<FSwing> Swings;
+
+	TArray<TWeakObjectPtr<UHitboxComponent>> ActiveHitboxes;
+	TArray<UHitboxComponent*> NearbyHitboxes;
+	TArray<AActor*> NearbyActors;
+
+	// Async sweeps in flight, by the user data shared by the steps of one swept frame.
+	TMap<uint32, FInFlightSweep> InFlightSweeps;
+	uint32 NextSweepId = 1;
+
+	FTraceDelegate AsyncSweepDelegate;
+};
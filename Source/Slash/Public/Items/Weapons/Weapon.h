@@ -4,12 +4,44 @@
 
 #include "CoreMinimal.h"
 #include "Items/Item.h"
+#include "Subsystems/FieldPoolSubsystem.h"
 #include "Weapon.generated.h"
 
 class USoundBase;
 class UBoxComponent;
 class UWeaponDamageComponent;
-class USphereComponent;
+class UFieldSystemComponent;
+struct FCollisionShape;
+struct FCollisionQueryParams;
+
+/**
+ * Actors hit by the current swing of a weapon, so each of them is hit once per swing.
+ * Inline storage, typical swings hit a handful of actors & never allocate.
+ */
+struct FSwingHitRegistry
+{
+	// Forget the hits of the last swing, returns the ID of the new one.
+	uint32 BeginSwing()
+	{
+		HitActors.Reset();
+		return ++SwingId;
+	}
+
+	// Record `Actor` as hit by swing `InSwingId`, false if it was hit already or the swing is over.
+	bool RegisterHit(uint32 InSwingId, const AActor* Actor)
+	{
+		if (InSwingId != SwingId || Actor == nullptr || HitActors.Contains(Actor)) return false;
+
+		HitActors.Add(Actor);
+		return true;
+	}
+
+	FORCEINLINE uint32 GetSwingId() const { return SwingId; }
+
+private:
+	uint32 SwingId = 0;
+	TArray<TWeakObjectPtr<const AActor>, TInlineAllocator<8>> HitActors;
+};
 
 /**
  * 
@@ -32,17 +64,45 @@ public:
 
 	void AttachMeshToSocket(USceneComponent* InParent, const FName& InSocketName);
 
-	TArray<AActor*> IgnoreActors;
+	// Show/hide the damage label, see `UDamageLabelSubsystem`.
+	void SetDamageHUDVisible(bool bVisible);
+
+	/** Hit detection, see `UMeleeTraceSubsystem` */
+
+	// Sweep the blade every frame while enabled, each enabling starts a new swing.
+	void SetHitDetectionEnabled(bool bEnabled);
+
+	// World transform of `BoxTraceStart`, the sweeps of a frame blend between its last two values.
+	FTransform GetBladeTransform() const;
+
+	// Box sweep along the blade at `BladeTransform`, from `BoxTraceStart` to `BoxTraceEnd`.
+	void GetSweep(const FTransform& BladeTransform, FVector& OutStart, FVector& OutEnd, FQuat& OutRotation) const;
+
+	// Swept box, ignoring the weapon & its owner. Actors already hit are filtered by `OnSweepHit()`.
+	void GetSweepQuery(FCollisionShape& OutShape, FCollisionQueryParams& OutQueryParams) const;
+
+	// Queue damage & hit reaction for one actor found by a sweep of swing `SwingId`, ignored if that
+	// swing is over or already hit the actor.
+	void OnSweepHit(const FHitResult& BoxHit, uint32 SwingId);
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	friend class UDamageQueueSubsystem;
 
 	bool ActorIsSameType(AActor* OtherActor);
 
-	void ExecuteGetHit(FHitResult& BoxHit);
+	void ExecuteGetHit(const FHitResult& BoxHit);
+
+	// Apply the impact fields through `UFieldPoolSubsystem`: `CreateFields()` if the Blueprint
+	// implements it, `ImpactFields` otherwise.
+	void ApplyImpactFields(const FVector& FieldLocation);
 
+	// Custom field graph of the weapon, apply it on `FieldComponent` (the pooled one).
+	// Only called for impacts the pool doesn't skip, with breakables within `ImpactFields.Radius`.
 	UFUNCTION(BlueprintImplementableEvent)
-	void CreateFields(const FVector& FieldLocation);
+	void CreateFields(const FVector& FieldLocation, UFieldSystemComponent* FieldComponent);
 
 private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
@@ -51,6 +111,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
 	bool bShowBoxDebug = false;
 
+	// Fields applied on the breakables around the impact points, unless the Blueprint implements `CreateFields()`.
+	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
+	FImpactFieldSettings ImpactFields;
+
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
 	USoundBase* EquipSound;
 
@@ -66,29 +130,28 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
 	float Damage = 20.0f;
 
-	UPROPERTY(VisibleAnywhere)
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon Properties")
+	float DamageHUDRadius = 500.0f;
+
+	// Damage label shown above weapons lying in the world as pickups, by `UDamageLabelSubsystem`.
+	// Set a Blueprint of `UWeaponDamageComponent` with the widget class, draw size, space & relative
+	// location of the label, no label is shown without it.
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon Properties")
+	TSubclassOf<UWeaponDamageComponent> DamageHUDComponentClass;
+
+	// Only created the first time the player comes within `DamageHUDRadius`, equipped weapons never
+	// get any HUD component.
+	UPROPERTY(Transient)
 	UWeaponDamageComponent* DamageHUDComponent;
 
-	// Detector sphere which is used to control when to show/hide `DamageHUDComponent`.
-	UPROPERTY(VisibleAnywhere)
-	USphereComponent* DamageHUDSphere;
+	FSwingHitRegistry HitRegistry;
 
 	void HideDamageHUDComponent();
 	void ShowDamageHUDComponent();
 
-	// Performs box-tracing for `WeaponBox`.
-	void BoxTrace(FHitResult& BoxHit);
-
-	UFUNCTION()
-	void OnBoxOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	UFUNCTION()
-	void OnDamageHUDSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	UFUNCTION()
-	void OnDamageHUDSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-
 public:
 	FORCEINLINE UBoxComponent* GetWeaponBox() const { return WeaponBox; }
 	FORCEINLINE float GetWeaponDamage() const { return Damage; }
+	FORCEINLINE uint32 GetSwingId() const { return HitRegistry.GetSwingId(); }
+	FORCEINLINE float GetDamageHUDRadius() const { return DamageHUDRadius; }
 };
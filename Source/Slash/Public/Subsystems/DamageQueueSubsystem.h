@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class AWeapon;
+
+/**
+ * Resolves the hits of a frame together, instead of inside the sweep or overlap that found them.
+ * Hits on the same victim are coalesced: their damage is summed & applied once, the victim reacts
+ * once (`GetHit()` montage, sound, particles) at the first impact point & fields are created once.
+ * Victims are resolved in the order of their first hit, at most
+ * `slash.Combat.MaxDamageVictimsPerFrame` per frame, the rest waits for the next frame.
+ */
+UCLASS()
+class SLASH_API UDamageQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Queue `Damage` from `Weapon` on `Victim`, resolved at the end of the frame.
+	void QueueHit(AActor* Victim, float Damage, AWeapon* Weapon, const FVector& ImpactPoint);
+
+	FORCEINLINE int32 GetNumPendingVictims() const { return PendingVictims.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<AActor> Victim;
+		TWeakObjectPtr<AWeapon> Weapon;  // Of the first hit, like the fields below
+		TWeakObjectPtr<AActor> Hitter;
+		TWeakObjectPtr<AController> InstigatorController;
+		FVector ImpactPoint = FVector::ZeroVector;
+		float Damage = 0.0f;
+		int32 NumHits = 0;
+	};
+
+	void ResolveDamage(const FPendingDamage& PendingDamage);
+
+	TArray<FPendingDamage> PendingVictims;
+};
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FieldPoolSubsystem.generated.h"
+
+class ABreakableActor;
+class UFieldSystemComponent;
+class URadialFalloff;
+class URadialVector;
+class UOperatorField;
+
+/*
+* Physics fields applied on breakables around a weapon impact.
+*/
+USTRUCT(BlueprintType)
+struct FImpactFieldSettings
+{
+	GENERATED_BODY()
+
+	// Only geometry collections within this radius of the impact are affected.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius = 200.0f;
+
+	// External strain applied to the clusters, breaks them when above their damage threshold.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float StrainMagnitude = 500000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 StrainIterations = 1;
+
+	// Force pushing the broken pieces away from the impact.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ForceMagnitude = 1000000.0f;
+};
+
+/**
+ * Applies the physics fields of weapon impacts through one reused field component, instead of
+ * spawning & garbage collecting field actors on every hit.
+ * Impacts with no `ABreakableActor` within the field radius are skipped, so are impacts over
+ * `slash.Combat.MaxFieldsPerFrame` or closer than `slash.Combat.FieldMinSpacing` to another field
+ * applied in the same frame.
+ */
+UCLASS()
+class SLASH_API UFieldPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterBreakable(ABreakableActor* Breakable);
+	void UnregisterBreakable(ABreakableActor* Breakable);
+
+	// Apply the strain & force fields at `Location`, returns false if skipped.
+	bool ApplyImpactFields(const FVector& Location, const FImpactFieldSettings& Settings);
+
+	// Reserve a field at `Location` for custom fields, returns the component to apply them on or
+	// null if skipped.
+	UFieldSystemComponent* ReserveImpactFields(const FVector& Location, float Radius);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	bool HasBreakableWithin(const FVector& Location, float Radius) const;
+	bool ReserveField(const FVector& Location);
+	UFieldSystemComponent* GetFieldComponent();
+
+	// Registered breakables, index `i` of every array below belongs to `Breakables[i]`.
+	TArray<TWeakObjectPtr<ABreakableActor>> Breakables;
+	TArray<FVector> BreakableLocations;
+	TArray<float> BreakableRadii;
+
+	// Fields applied in `FieldsFrame`.
+	TArray<FVector, TInlineAllocator<8>> FieldLocations;
+	uint64 FieldsFrame = MAX_uint64;
+
+	// Owner of `FieldComponent`, spawned with the first field.
+	UPROPERTY(Transient)
+	AActor* FieldActor;
+
+	UPROPERTY(Transient)
+	UFieldSystemComponent* FieldComponent;
+
+	// Field nodes reconfigured for every impact, commands copy them when dispatched.
+	UPROPERTY(Transient)
+	URadialFalloff* StrainFalloff;
+
+	UPROPERTY(Transient)
+	URadialFalloff* ForceFalloff;
+
+	UPROPERTY(Transient)
+	URadialVector* ForceDirection;
+
+	UPROPERTY(Transient)
+	UOperatorField* Force;
+};
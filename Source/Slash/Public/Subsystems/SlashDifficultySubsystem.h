@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Characters/CharacterTypes.h"
+#include "SlashDifficultySubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameDifficultyChanged, EGameDifficulty);
+
+/**
+ * Difficulty chosen by the player, kept by the game instance so it survives map travel.
+ * World subsystems depending on it (e.g. `UAttackTokenSubsystem`) read it when created &
+ * follow its changes.
+ */
+UCLASS()
+class SLASH_API USlashDifficultySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = Combat)
+	void SetDifficulty(EGameDifficulty NewDifficulty);
+
+	UFUNCTION(BlueprintPure, Category = Combat)
+	EGameDifficulty GetDifficulty() const { return Difficulty; }
+
+	FOnGameDifficultyChanged OnDifficultyChanged;
+
+private:
+	EGameDifficulty Difficulty = EGameDifficulty::EGD_Normal;
+};
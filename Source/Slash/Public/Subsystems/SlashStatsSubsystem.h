@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Slash/SlashStats.h"
+#include "SlashStatsSubsystem.generated.h"
+
+/**
+ * Collects `FSlashPerf` timings & counts while `slash.Stats.Overlay` or `slash.Stats.LogInterval`
+ * is set, nothing is collected otherwise.
+ * The overlay shows the average milliseconds & counts per frame of each gameplay system & AI hot path on screen,
+ * the log writes the same averages to `LogSlashStats`, e.g. from a headless server.
+ * Not available in Shipping builds.
+ */
+UCLASS()
+class SLASH_API USlashStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Sums of the frames since the window started.
+	struct FStatsWindow
+	{
+		double Seconds[FSlashPerf::NumSystems] = {};
+		int64 Counts[FSlashPerf::NumSystems] = {};
+		double FrameSeconds = 0.0;
+		int32 NumFrames = 0;
+
+		void AddFrame(const FSlashPerfSnapshot& Frame, float DeltaTime);
+		void Reset();
+	};
+
+	void ShowOverlay();
+	void WriteLog();
+
+	FStatsWindow OverlayWindow;
+	FStatsWindow LogWindow;
+
+	// Totals at the end of the previous frame, while this subsystem is a `FSlashPerf` collector.
+	FSlashPerfSnapshot LastSnapshot;
+	bool bCollecting = false;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashSubsystem.generated.h"
+
+/*
+* Categories of actors tracked by `USpatialHashSubsystem`, combined as a bitmask in queries.
+*/
+namespace ESpatialCategory
+{
+	enum Type : uint8
+	{
+		ESC_None = 0,
+		ESC_Enemy = 1 << 0,
+		ESC_Player = 1 << 1,
+		ESC_Pickup = 1 << 2,
+
+		ESC_Pawns = ESC_Enemy | ESC_Player,
+		ESC_All = 0xFF
+	};
+}
+
+/**
+ * Uniform grid of the gameplay relevant actors in the world.
+ * Positions are cached once per frame, so range checks use squared distances between
+ * cached locations instead of calling `GetActorLocation()` on every query.
+ */
+UCLASS()
+class SLASH_API USpatialHashSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+	/** </UTickableWorldSubsystem> */
+
+	// Registration & removal are applied to the grid by the next per frame rebuild, queries before
+	// it still find new actors & skip removed ones.
+	void RegisterActor(AActor* Actor, ESpatialCategory::Type Category);
+	void UnregisterActor(AActor* Actor);
+	bool IsRegistered(const AActor* Actor) const;
+
+	// Collects all registered actors of `CategoryMask` within `Radius` of `Origin`.
+	void QueryRadius(const FVector& Origin, double Radius, uint8 CategoryMask, TArray<AActor*>& OutActors);
+
+	// Whether `Target` is within `Radius` of `Source`, using cached locations when possible.
+	bool IsWithinRange(const AActor* Source, const AActor* Target, double Radius);
+
+	// Squared distance between both actors, using cached locations when possible.
+	double GetDistanceSquared(const AActor* Source, const AActor* Target);
+
+	// Location of `Actor` as of the last refresh, falls back to the live location if not registered.
+	FVector GetCachedLocation(const AActor* Actor);
+
+	// Explicitly refresh the grid, does nothing if it has already been refreshed this frame.
+	void RefreshIfStale();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void Rebuild();
+	FIntPoint GetCell(const FVector& Location) const;
+	static uint64 GetCellKey(const FIntPoint& Cell);
+
+	// Registered actors, index `i` of every array below belongs to `Actors[i]`.
+	UPROPERTY()
+	TArray<AActor*> Actors;
+
+	TArray<FVector> Locations;
+	TArray<uint8> Categories;
+	TArray<uint64> CellKeys;
+
+	TMap<const AActor*, int32> ActorIndices;
+
+	// Entry indices sorted by cell, each cell maps to a contiguous range of `SortedEntries`.
+	TArray<int32> SortedEntries;
+	TMap<uint64, FIntPoint> CellRanges;  // X = first index in `SortedEntries`, Y = count
+
+	// Entries registered since the last rebuild, checked one by one by queries.
+	TArray<int32> UnsortedEntries;
+
+	// Slots of the actors unregistered since the last rebuild, freed by it.
+	TArray<int32> RemovedEntries;
+
+	double CellSize = 1000.0;
+	uint64 LastRefreshFrame = MAX_uint64;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/EngineTypes.h"
+
+/*
+* Custom collision channels & profiles used by Slash, set in `Config/DefaultEngine.ini`.
+* Each profile only responds to the channels it needs, so unwanted pairs are filtered by the
+* physics engine instead of in overlap callbacks.
+*/
+
+// Object channel of the per-limb capsules of `UHitboxComponent`.
+#define ECC_SlashHitbox ECollisionChannel::ECC_GameTraceChannel1
+
+// Trace channel of the weapon sweeps, blocked only by hitboxes & breakables.
+#define ECC_WeaponTrace ECollisionChannel::ECC_GameTraceChannel2
+
+// Object channel of `AItem::Sphere`, overlapped by pawns by default.
+#define ECC_SlashPickup ECollisionChannel::ECC_GameTraceChannel3
+
+// Object channel of the detection spheres of characters, overlapped by pawns by default.
+#define ECC_SlashSensor ECollisionChannel::ECC_GameTraceChannel4
+
+// Object channel of the weapon boxes, which have no collision.
+#define ECC_SlashWeapon ECollisionChannel::ECC_GameTraceChannel5
+
+namespace SlashCollisionProfile
+{
+	// Overlaps pawn capsules only.
+	inline const FName Pickup(TEXT("SlashPickup"));
+
+	// Overlaps pawn capsules only.
+	inline const FName Sensor(TEXT("SlashSensor"));
+
+	// No collision, the box is only the shape of the weapon sweeps.
+	inline const FName Weapon(TEXT("SlashWeapon"));
+
+	// Blocks `ECC_WeaponTrace` only.
+	inline const FName Hitbox(TEXT("SlashHitbox"));
+}
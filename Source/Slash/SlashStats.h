@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Stats/Stats.h"
+
+/*
+* Stat groups used by Slash gameplay systems.
+* View them in game with console commands: `stat SlashAI`, `stat SlashCombat`, `stat SlashItems`,
+* `stat SlashHUD`, `stat SlashSpawns`
+*/
+
+DECLARE_STATS_GROUP(TEXT("SlashAI"), STATGROUP_SlashAI, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("SlashCombat"), STATGROUP_SlashCombat, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("SlashItems"), STATGROUP_SlashItems, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("SlashHUD"), STATGROUP_SlashHUD, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("SlashSpawns"), STATGROUP_SlashSpawns, STATCAT_Advanced);
+
+/*
+* Timings & counts of each gameplay system & of the AI hot paths, only collected while a collector
+* needs them: `USlashStatsSubsystem` (`slash.Stats.Overlay`, `slash.Stats.LogInterval`) or the
+* `SlashAIBenchmark` commandlet.
+* Unlike `stat` groups, they're also available in Test builds & headless servers.
+* Values are running totals, collectors diff two `FSlashPerfSnapshot`s to get a frame or a window.
+* Scopes are inclusive: a soul spawned while resolving damage counts in both systems, a
+* `MoveToTarget` issued from a range check counts in both hot paths & in `EnemyAI`.
+*/
+
+enum class ESlashPerfSystem : uint8
+{
+	// Gameplay systems
+	ESPS_EnemyAI,
+	ESPS_WeaponTraces,
+	ESPS_Damage,
+	ESPS_Pickups,
+	ESPS_HUD,
+	ESPS_Spawns,
+
+	// AI hot paths, parts of `ESPS_EnemyAI`
+	ESPS_EnemyTick,
+	ESPS_EnemyAIBatchTick,
+	ESPS_CombatRangeChecks,
+	ESPS_MoveToTarget,
+
+	ESPS_MAX
+};
+
+struct FSlashPerf
+{
+	static constexpr int32 NumSystems = static_cast<int32>(ESlashPerfSystem::ESPS_MAX);
+
+	static inline double Seconds[NumSystems] = {};
+	static inline int64 Counts[NumSystems] = {};
+
+	FORCEINLINE static bool IsEnabled() { return NumCollectors > 0; }
+
+	// Collection runs while at least one collector is added.
+	static void AddCollector() { NumCollectors++; }
+	static void RemoveCollector() { if (NumCollectors > 0) NumCollectors--; }
+
+	static const TCHAR* GetSystemName(int32 Index)
+	{
+		static const TCHAR* Names[] = {
+			TEXT("EnemyAI"), TEXT("WeaponTraces"), TEXT("Damage"), TEXT("Pickups"), TEXT("HUD"), TEXT("Spawns"),
+			TEXT("EnemyTick"), TEXT("EnemyAIBatchTick"), TEXT("CombatRangeChecks"), TEXT("MoveToTarget")
+		};
+		static_assert(UE_ARRAY_COUNT(Names) == NumSystems, "Name every ESlashPerfSystem.");
+		return Names[Index];
+	}
+
+private:
+	static inline int32 NumCollectors = 0;
+};
+
+// Copy of the `FSlashPerf` totals, the difference of two snapshots covers the time between them.
+struct FSlashPerfSnapshot
+{
+	double Seconds[FSlashPerf::NumSystems] = {};
+	int64 Counts[FSlashPerf::NumSystems] = {};
+
+	static FSlashPerfSnapshot Take()
+	{
+		FSlashPerfSnapshot Snapshot;
+		for (int32 Index = 0; Index < FSlashPerf::NumSystems; Index++)
+		{
+			Snapshot.Seconds[Index] = FSlashPerf::Seconds[Index];
+			Snapshot.Counts[Index] = FSlashPerf::Counts[Index];
+		}
+		return Snapshot;
+	}
+
+	FSlashPerfSnapshot operator-(const FSlashPerfSnapshot& Other) const
+	{
+		FSlashPerfSnapshot Difference;
+		for (int32 Index = 0; Index < FSlashPerf::NumSystems; Index++)
+		{
+			Difference.Seconds[Index] = Seconds[Index] - Other.Seconds[Index];
+			Difference.Counts[Index] = Counts[Index] - Other.Counts[Index];
+		}
+		return Difference;
+	}
+
+	FORCEINLINE double GetSeconds(ESlashPerfSystem System) const { return Seconds[static_cast<int32>(System)]; }
+};
+
+class FSlashPerfScope
+{
+public:
+	explicit FSlashPerfScope(ESlashPerfSystem InSystem)
+		: System(InSystem), StartCycles(FSlashPerf::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FSlashPerfScope()
+	{
+		if (StartCycles != 0)
+		{
+			FSlashPerf::Seconds[static_cast<int32>(System)] += FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	ESlashPerfSystem System;
+	uint64 StartCycles;
+};
+
+#if UE_BUILD_SHIPPING
+#define SLASH_PERF_SCOPE(System)
+#define SLASH_PERF_COUNT(System, Count)
+#else
+#define SLASH_PERF_SCOPE(System) FSlashPerfScope PREPROCESSOR_JOIN(SlashPerfScope, __LINE__)(ESlashPerfSystem::System)
+#define SLASH_PERF_COUNT(System, Count) do { if (FSlashPerf::IsEnabled()) { FSlashPerf::Counts[static_cast<int32>(ESlashPerfSystem::System)] += (Count); } } while (0)
+#endif